@@ -87,6 +87,9 @@ class JsonCGAL:
         try:
             if not self.validate_format(json_data):
                 return
+            if json_data.lstrip().startswith('{'):
+                self.decode_columns(json.loads(json_data))
+                return
             objs = json.loads(json_data, object_hook=self.decoder)
             if objs is not None:
                 self.points = [obj for obj in objs if type(obj) == Point_2]
@@ -95,6 +98,36 @@ class JsonCGAL:
         except Exception as caught_exception:
             print('ERROR: {}'.format(caught_exception))
 
+    def decode_columns(self, blocks: dict):
+        """
+        decode the columnar layout, one block of equal length coordinate
+        columns per type, e.g. {'point_2': {'x': [...], 'y': [...]}}.
+        Only point, segment and line blocks can be decoded, any other block
+        raises a ValueError rather than being dropped.
+        """
+        unsupported = sorted(set(blocks) - {'point_2', 'segment_2', 'line_2'})
+        if unsupported:
+            raise ValueError('unsupported columnar geometry blocks: {}'.format(', '.join(unsupported)))
+        if 'point_2' in blocks:
+            block = blocks['point_2']
+            self.points = [Point_2(x, y) for x, y in zip(block['x'], block['y'])]
+        if 'segment_2' in blocks:
+            block = blocks['segment_2']
+            self.segments = [Segment_2(Point_2(x0, y0), Point_2(x1, y1)) for x0, y0, x1, y1
+                             in zip(block['x0'], block['y0'], block['x1'], block['y1'])]
+        if 'line_2' in blocks:
+            # lines are stored as the coefficients of ax + by + c = 0
+            block = blocks['line_2']
+            self.lines = [Line_2(*self.line_points(a, b, c)) for a, b, c
+                          in zip(block['a'], block['b'], block['c'])]
+
+    @staticmethod
+    def line_points(a: float, b: float, c: float):
+        """ two points on the line ax + by + c = 0 """
+        if b != 0:
+            return Point_2(0, -c / b), Point_2(b, -(a * b + c) / b)
+        return Point_2(-c / a, 0), Point_2(-c / a, -a)
+
     def encode(self):
         """ encode data as json string """
         objs = []
@@ -0,0 +1,623 @@
+/**
+ * @file JsonCGAL-benchmark.cpp
+ * @author Graham Riches (graham.riches@live.com)
+ * @brief throughput benchmarks for loading, dumping and querying geometry
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+#include <type_traits>
+
+#include "benchmark/benchmark.h"
+#include "JsonCGAL.h"
+#include "JsonCGALTypes.h"
+#include "cgal_kernel_config.h"
+#include <CGAL/intersections.h>
+
+/*
+ * every heap allocation made by the process is counted so each benchmark can
+ * report the allocations made per operation. The plain, nothrow and aligned
+ * forms are all replaced, the array forms forward to them by default.
+ */
+static std::atomic<std::size_t> allocation_count(0);
+
+static void *counted_alloc(std::size_t size, std::size_t alignment)
+{
+	allocation_count.fetch_add(1, std::memory_order_relaxed);
+	size = size ? size : 1;
+	if (alignment <= alignof(std::max_align_t))
+	{
+		return std::malloc(size);
+	}
+#if defined(_MSC_VER)
+	return _aligned_malloc(size, alignment);
+#else
+	/* aligned_alloc wants a size that is a multiple of the alignment */
+	return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+}
+
+static void counted_free(void *memory, [[maybe_unused]] std::size_t alignment)
+{
+#if defined(_MSC_VER)
+	if (alignment > alignof(std::max_align_t))
+	{
+		_aligned_free(memory);
+		return;
+	}
+#endif
+	std::free(memory);
+}
+
+void *operator new(std::size_t size)
+{
+	void *memory = counted_alloc(size, alignof(std::max_align_t));
+	if (memory == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+	return counted_alloc(size, alignof(std::max_align_t));
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+	void *memory = counted_alloc(size, static_cast<std::size_t>(alignment));
+	if (memory == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+	return counted_alloc(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void *memory) noexcept
+{
+	counted_free(memory, alignof(std::max_align_t));
+}
+
+void operator delete(void *memory, std::size_t /*size*/) noexcept
+{
+	counted_free(memory, alignof(std::max_align_t));
+}
+
+void operator delete(void *memory, const std::nothrow_t &) noexcept
+{
+	counted_free(memory, alignof(std::max_align_t));
+}
+
+void operator delete(void *memory, std::align_val_t alignment) noexcept
+{
+	counted_free(memory, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void *memory, std::size_t /*size*/, std::align_val_t alignment) noexcept
+{
+	counted_free(memory, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void *memory, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+	counted_free(memory, static_cast<std::size_t>(alignment));
+}
+
+/* smallest and largest dataset sizes, in objects */
+static const int min_objects = 1000;
+static const int max_objects = 10000000;
+
+/**
+ * \brief deterministic synthetic objects of one type, built from their flat
+ *        coordinate layout so every supported type is covered
+ */
+template <class T>
+static CGAL_list<T> make_objects(std::size_t count)
+{
+	std::mt19937_64 generator(count);
+	std::uniform_real_distribution<double> coordinate(-1000.0, 1000.0);
+	double values[T::coordinate_count];
+	CGAL_list<T> objects;
+	objects.reserve(count);
+	for (std::size_t i = 0; i < count; i++)
+	{
+		for (std::size_t j = 0; j < T::coordinate_count; j++)
+		{
+			values[j] = coordinate(generator);
+		}
+		if (std::is_same<T, JsonCGAL::Circle_2d>::value)
+		{
+			/* squared radius must be positive */
+			values[2] = values[2] * values[2];
+		}
+		objects.push_back(T::unflatten(values));
+	}
+	return objects;
+}
+
+/**
+ * \brief container holding count synthetic objects of type T
+ */
+template <class T>
+static void fill_container(JsonCGAL::JsonCGAL &json_data, std::size_t count)
+{
+	json_data.add_objects(make_objects<T>(count));
+}
+
+/**
+ * \brief container holding count objects split between the three types that
+ *        have a json encoding, interleaved in runs so the insertion order matters
+ */
+static void fill_mixed_container(JsonCGAL::JsonCGAL &json_data, std::size_t count)
+{
+	const std::size_t run = 64;
+	CGAL_list<JsonCGAL::Point_2d> points = make_objects<JsonCGAL::Point_2d>(count);
+	CGAL_list<JsonCGAL::Segment_2d> segments = make_objects<JsonCGAL::Segment_2d>(count);
+	CGAL_list<JsonCGAL::Line_2d> lines = make_objects<JsonCGAL::Line_2d>(count);
+	for (std::size_t first = 0; first < count; first += run)
+	{
+		std::size_t last = (first + run < count) ? first + run : count;
+		switch ((first / run) % 3)
+		{
+		case 0: json_data.add_objects(CGAL_list<JsonCGAL::Point_2d>(points.begin() + first, points.begin() + last)); break;
+		case 1: json_data.add_objects(CGAL_list<JsonCGAL::Segment_2d>(segments.begin() + first, segments.begin() + last)); break;
+		default: json_data.add_objects(CGAL_list<JsonCGAL::Line_2d>(lines.begin() + first, lines.begin() + last)); break;
+		}
+	}
+}
+
+/**
+ * \brief report objects/sec, bytes/sec and allocations per operation
+ */
+static void report(benchmark::State &state, std::size_t objects, std::size_t bytes, std::size_t allocations)
+{
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * objects));
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+	state.counters["allocs_per_op"] = benchmark::Counter(static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+}
+
+/* types with a json encoding, used by the json benchmarks */
+struct Points { static void fill(JsonCGAL::JsonCGAL &json_data, std::size_t count) { fill_container<JsonCGAL::Point_2d>(json_data, count); } };
+struct Segments { static void fill(JsonCGAL::JsonCGAL &json_data, std::size_t count) { fill_container<JsonCGAL::Segment_2d>(json_data, count); } };
+struct Lines { static void fill(JsonCGAL::JsonCGAL &json_data, std::size_t count) { fill_container<JsonCGAL::Line_2d>(json_data, count); } };
+struct Mixed { static void fill(JsonCGAL::JsonCGAL &json_data, std::size_t count) { fill_mixed_container(json_data, count); } };
+
+template <class Dataset>
+static void BM_LoadFromString(benchmark::State &state)
+{
+	JsonCGAL::JsonCGAL create_json_data;
+	std::size_t count = static_cast<std::size_t>(state.range(0));
+	Dataset::fill(create_json_data, count);
+	std::string json_string = create_json_data.dump_to_string();
+	std::size_t allocations = allocation_count.load();
+	for (auto _ : state)
+	{
+		JsonCGAL::JsonCGAL json_data;
+		benchmark::DoNotOptimize(json_data.load_from_string(json_string));
+	}
+	report(state, count, json_string.size(), allocation_count.load() - allocations);
+}
+
+/* lazy load of a mixed file that only reads its segments */
+static void BM_LazyLoadSegmentsFromMixed(benchmark::State &state)
+{
+	JsonCGAL::JsonCGAL create_json_data;
+	JsonCGAL::LoadOptions options;
+	std::size_t count = static_cast<std::size_t>(state.range(0));
+	options.lazy = true;
+	fill_mixed_container(create_json_data, count);
+	std::string json_string = create_json_data.dump_to_string();
+	std::size_t allocations = allocation_count.load();
+	for (auto _ : state)
+	{
+		JsonCGAL::JsonCGAL json_data;
+		benchmark::DoNotOptimize(json_data.load_from_string(json_string, options));
+		benchmark::DoNotOptimize(json_data.view<JsonCGAL::Segment_2d>().size());
+	}
+	report(state, count, json_string.size(), allocation_count.load() - allocations);
+}
+
+template <class Dataset>
+static void BM_Load(benchmark::State &state)
+{
+	JsonCGAL::JsonCGAL create_json_data;
+	std::size_t count = static_cast<std::size_t>(state.range(0));
+	std::string filename = "benchmark_load.json";
+	Dataset::fill(create_json_data, count);
+	std::string json_string = create_json_data.dump_to_string();
+	create_json_data.dump(filename);
+	std::size_t allocations = allocation_count.load();
+	for (auto _ : state)
+	{
+		JsonCGAL::JsonCGAL json_data;
+		benchmark::DoNotOptimize(json_data.load(filename));
+	}
+	report(state, count, json_string.size(), allocation_count.load() - allocations);
+	std::remove(filename.c_str());
+}
+
+/* stream load of a json lines file, read directly or on a read ahead thread */
+static void BM_LoadJsonLines(benchmark::State &state)
+{
+	JsonCGAL::JsonCGAL create_json_data;
+	JsonCGAL::LoadOptions options;
+	std::size_t count = static_cast<std::size_t>(state.range(0));
+	std::string filename = "benchmark_load.jsonl";
+	options.memory_map = false;
+	options.read_ahead = (state.range(1) != 0);
+	fill_mixed_container(create_json_data, count);
+	std::string json_string = create_json_data.dump_to_string(JsonCGAL::FileFormat::json_lines);
+	create_json_data.dump(filename, JsonCGAL::FileFormat::json_lines);
+	std::size_t allocations = allocation_count.load();
+	for (auto _ : state)
+	{
+		JsonCGAL::JsonCGAL json_data;
+		benchmark::DoNotOptimize(json_data.load(filename, options));
+	}
+	report(state, count, json_string.size(), allocation_count.load() - allocations);
+	std::remove(filename.c_str());
+}
+
+/* reduction over the points of a file without keeping them */
+static void BM_ForEachPoint(benchmark::State &state)
+{
+	JsonCGAL::JsonCGAL create_json_data;
+	std::size_t count = static_cast<std::size_t>(state.range(0));
+	std::string filename = "benchmark_for_each.json";
+	fill_container<JsonCGAL::Point_2d>(create_json_data, count);
+	std::string json_string = create_json_data.dump_to_string();
+	create_json_data.dump(filename);
+	std::size_t allocations = allocation_count.load();
+	for (auto _ : state)
+	{
+		double sum = 0;
+		benchmark::DoNotOptimize(JsonCGAL::JsonCGAL::for_each_object<JsonCGAL::Point_2d>(filename, [&sum](const JsonCGAL::Point_2d &point) { sum += point.x(); }));
+		benchmark::DoNotOptimize(sum);
+	}
+	report(state, count, json_string.size(), allocation_count.load() - allocations);
+	std::remove(filename.c_str());
+}
+
+template <class Dataset>
+static void BM_DumpToString(benchmark::State &state)
+{
+	JsonCGAL::JsonCGAL json_data;
+	std::size_t count = static_cast<std::size_t>(state.range(0));
+	std::size_t bytes = 0;
+	Dataset::fill(json_data, count);
+	std::size_t allocations = allocation_count.load();
+	for (auto _ : state)
+	{
+		std::string json_string = json_data.dump_to_string();
+		bytes = json_string.size();
+		benchmark::DoNotOptimize(json_string.data());
+	}
+	report(state, count, bytes, allocation_count.load() - allocations);
+}
+
+template <class Dataset>
+static void BM_Dump(benchmark::State &state)
+{
+	JsonCGAL::JsonCGAL json_data;
+	std::size_t count = static_cast<std::size_t>(state.range(0));
+	std::string filename = "benchmark_dump.json";
+	Dataset::fill(json_data, count);
+	std::size_t bytes = json_data.dump_to_string().size() + 1;
+	std::size_t allocations = allocation_count.load();
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(json_data.dump(filename));
+	}
+	report(state, count, bytes, allocation_count.load() - allocations);
+	std::remove(filename.c_str());
+}
+
+/* gzip compressed dump of a mixed file on one thread or on every hardware thread */
+static void BM_DumpGzip(benchmark::State &state)
+{
+	JsonCGAL::JsonCGAL json_data;
+	JsonCGAL::DumpOptions options;
+	std::size_t count = static_cast<std::size_t>(state.range(0));
+	std::string filename = "benchmark_dump.json.gz";
+	options.compression = JsonCGAL::Compression::gzip;
+	options.threads = static_cast<unsigned>(state.range(1));
+	fill_mixed_container(json_data, count);
+	std::size_t bytes = json_data.dump_to_string().size() + 1;
+	std::size_t allocations = allocation_count.load();
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(json_data.dump(filename, options));
+	}
+	report(state, count, bytes, allocation_count.load() - allocations);
+	std::remove(filename.c_str());
+}
+
+/* point cloud dump and reload in double and single precision, as json (0) or binary (1) */
+template <class K>
+static void BM_PointCloudRoundTrip(benchmark::State &state)
+{
+	typedef JsonCGAL::BasicJsonCGAL<K> Container;
+	Container create_json_data;
+	JsonCGAL::DumpOptions options;
+	std::size_t count = static_cast<std::size_t>(state.range(0));
+	std::size_t bytes = 0;
+	options.format = state.range(1) ? JsonCGAL::FileFormat::binary : JsonCGAL::FileFormat::json;
+	options.indent = -1;
+	CGAL_list<JsonCGAL::Point_2d> points = make_objects<JsonCGAL::Point_2d>(count);
+	for (const JsonCGAL::Point_2d &point : points)
+	{
+		create_json_data.template emplace_object<typename Container::Point_2d>(point.x(), point.y());
+	}
+	std::size_t allocations = allocation_count.load();
+	for (auto _ : state)
+	{
+		std::string output = create_json_data.dump_to_string(options);
+		Container json_data;
+		benchmark::DoNotOptimize(json_data.load_from_string(output));
+		bytes = output.size();
+	}
+	report(state, count, bytes, allocation_count.load() - allocations);
+	state.counters["bytes_per_point"] = static_cast<double>(bytes) / static_cast<double>(count);
+	state.counters["memory_per_point"] = static_cast<double>(sizeof(typename Container::Point_2d));
+}
+
+/* segments in a viewport of 1/100th of the data extent, found with the spatial index (1) or a scan (0) */
+static void BM_QuerySegments(benchmark::State &state)
+{
+	JsonCGAL::JsonCGAL json_data;
+	std::size_t count = static_cast<std::size_t>(state.range(0));
+	bool indexed = state.range(1) != 0;
+	std::mt19937_64 generator(count);
+	std::uniform_real_distribution<double> corner(-1000.0, 900.0);
+	std::uniform_real_distribution<double> offset(-1.0, 1.0);
+	CGAL_list<JsonCGAL::Point_2d> points = make_objects<JsonCGAL::Point_2d>(count);
+	for (const JsonCGAL::Point_2d &point : points)
+	{
+		json_data.emplace_object<JsonCGAL::Segment_2d>(point, Kernel::Point_2(point.x() + offset(generator), point.y() + offset(generator)));
+	}
+	json_data.build_index();
+	std::size_t found = 0;
+	std::size_t allocations = allocation_count.load();
+	for (auto _ : state)
+	{
+		Kernel::Point_2 low(corner(generator), corner(generator));
+		Kernel::Iso_rectangle_2 box(low, Kernel::Point_2(low.x() + 100.0, low.y() + 100.0));
+		if (indexed)
+		{
+			found = json_data.query(box).size();
+		}
+		else
+		{
+			found = 0;
+			for (const JsonCGAL::Segment_2d &segment : json_data.view<JsonCGAL::Segment_2d>())
+			{
+				found += CGAL::do_intersect(segment, box) ? 1 : 0;
+			}
+		}
+		benchmark::DoNotOptimize(found);
+	}
+	report(state, count, 0, allocation_count.load() - allocations);
+	state.counters["found"] = static_cast<double>(found);
+}
+
+/* load a file of short segments whole or only the part reaching into a small region */
+static void BM_LoadRegion(benchmark::State &state)
+{
+	JsonCGAL::JsonCGAL create_json_data;
+	std::size_t count = static_cast<std::size_t>(state.range(0));
+	bool region_only = state.range(1) != 0;
+	std::mt19937_64 generator(count);
+	std::uniform_real_distribution<double> offset(-1.0, 1.0);
+	for (const JsonCGAL::Point_2d &point : make_objects<JsonCGAL::Point_2d>(count))
+	{
+		create_json_data.emplace_object<JsonCGAL::Segment_2d>(point, Kernel::Point_2(point.x() + offset(generator), point.y() + offset(generator)));
+	}
+	std::string binary = create_json_data.dump_to_string(JsonCGAL::FileFormat::binary);
+	Kernel::Iso_rectangle_2 region(Kernel::Point_2(0, 0), Kernel::Point_2(100, 100));
+	std::size_t kept = 0;
+	std::size_t allocations = allocation_count.load();
+	for (auto _ : state)
+	{
+		JsonCGAL::JsonCGAL json_data;
+		benchmark::DoNotOptimize(region_only ? json_data.load_from_string(binary, region) : json_data.load_from_string(binary));
+		kept = json_data.size();
+	}
+	report(state, count, binary.size(), allocation_count.load() - allocations);
+	state.counters["kept"] = static_cast<double>(kept);
+}
+
+/* write short segments to a binary or tiled file, returning its size */
+static std::size_t dump_segment_file(const std::string &filename, std::size_t count, JsonCGAL::FileFormat::FileFormat format)
+{
+	JsonCGAL::JsonCGAL create_json_data;
+	std::mt19937_64 generator(count);
+	std::uniform_real_distribution<double> offset(-1.0, 1.0);
+	for (const JsonCGAL::Point_2d &point : make_objects<JsonCGAL::Point_2d>(count))
+	{
+		create_json_data.emplace_object<JsonCGAL::Segment_2d>(point, Kernel::Point_2(point.x() + offset(generator), point.y() + offset(generator)));
+	}
+	create_json_data.dump(filename, format);
+	return create_json_data.dump_to_string(format).size();
+}
+
+/* region load of a binary file, which decodes every object, and of a tiled file, which reads only the tiles in the region */
+static void BM_LoadTiledRegion(benchmark::State &state)
+{
+	std::size_t count = static_cast<std::size_t>(state.range(0));
+	std::string filename = "benchmark_load_region.jcgb";
+	std::size_t bytes = dump_segment_file(filename, count, state.range(1) ? JsonCGAL::FileFormat::tiled : JsonCGAL::FileFormat::binary);
+	Kernel::Iso_rectangle_2 region(Kernel::Point_2(0, 0), Kernel::Point_2(100, 100));
+	std::size_t kept = 0;
+	std::size_t allocations = allocation_count.load();
+	for (auto _ : state)
+	{
+		JsonCGAL::JsonCGAL json_data;
+		benchmark::DoNotOptimize(json_data.load(filename, region));
+		kept = json_data.size();
+	}
+	report(state, count, bytes, allocation_count.load() - allocations);
+	state.counters["kept"] = static_cast<double>(kept);
+	std::remove(filename.c_str());
+}
+
+/* full load of a tiled file, on one thread or every hardware thread */
+static void BM_LoadTiled(benchmark::State &state)
+{
+	std::size_t count = static_cast<std::size_t>(state.range(0));
+	std::string filename = "benchmark_load.jcgt";
+	std::size_t bytes = dump_segment_file(filename, count, JsonCGAL::FileFormat::tiled);
+	JsonCGAL::LoadOptions options;
+	options.threads = static_cast<unsigned>(state.range(1));
+	std::size_t allocations = allocation_count.load();
+	for (auto _ : state)
+	{
+		JsonCGAL::JsonCGAL json_data;
+		benchmark::DoNotOptimize(json_data.load(filename, options));
+	}
+	report(state, count, bytes, allocation_count.load() - allocations);
+	std::remove(filename.c_str());
+}
+
+/* the binary format encodes every supported type, so it is measured per type */
+template <class T>
+static void BM_BinaryLoadFromString(benchmark::State &state)
+{
+	JsonCGAL::JsonCGAL create_json_data;
+	std::size_t count = static_cast<std::size_t>(state.range(0));
+	fill_container<T>(create_json_data, count);
+	std::string binary = create_json_data.dump_to_string(JsonCGAL::FileFormat::binary);
+	std::size_t allocations = allocation_count.load();
+	for (auto _ : state)
+	{
+		JsonCGAL::JsonCGAL json_data;
+		benchmark::DoNotOptimize(json_data.load_from_string(binary));
+	}
+	report(state, count, binary.size(), allocation_count.load() - allocations);
+}
+
+template <class T>
+static void BM_BinaryDumpToString(benchmark::State &state)
+{
+	JsonCGAL::JsonCGAL json_data;
+	std::size_t count = static_cast<std::size_t>(state.range(0));
+	std::size_t bytes = 0;
+	fill_container<T>(json_data, count);
+	std::size_t allocations = allocation_count.load();
+	for (auto _ : state)
+	{
+		std::string binary = json_data.dump_to_string(JsonCGAL::FileFormat::binary);
+		bytes = binary.size();
+		benchmark::DoNotOptimize(binary.data());
+	}
+	report(state, count, bytes, allocation_count.load() - allocations);
+}
+
+template <class T>
+static void BM_AddObjects(benchmark::State &state)
+{
+	std::size_t count = static_cast<std::size_t>(state.range(0));
+	CGAL_list<T> objects = make_objects<T>(count);
+	std::size_t allocations = allocation_count.load();
+	for (auto _ : state)
+	{
+		JsonCGAL::JsonCGAL json_data;
+		json_data.add_objects(objects);
+		benchmark::DoNotOptimize(json_data.size());
+	}
+	report(state, count, count * sizeof(T), allocation_count.load() - allocations);
+}
+
+template <class T>
+static void BM_GetObjects(benchmark::State &state)
+{
+	JsonCGAL::JsonCGAL json_data;
+	std::size_t count = static_cast<std::size_t>(state.range(0));
+	fill_container<T>(json_data, count);
+	std::size_t allocations = allocation_count.load();
+	for (auto _ : state)
+	{
+		CGAL_list<T> objects = json_data.get_objects<T>();
+		benchmark::DoNotOptimize(objects.data());
+	}
+	report(state, count, count * sizeof(T), allocation_count.load() - allocations);
+}
+
+template <class T>
+static void BM_View(benchmark::State &state)
+{
+	JsonCGAL::JsonCGAL json_data;
+	std::size_t count = static_cast<std::size_t>(state.range(0));
+	fill_container<T>(json_data, count);
+	std::size_t allocations = allocation_count.load();
+	for (auto _ : state)
+	{
+		double values[T::coordinate_count];
+		double sum = 0;
+		for (const T &object : json_data.view<T>())
+		{
+			object.flatten(values);
+			sum += values[0];
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	report(state, count, count * sizeof(T), allocation_count.load() - allocations);
+}
+
+#define JSON_CGAL_BENCHMARK(function, type) \
+	BENCHMARK_TEMPLATE(function, type)->RangeMultiplier(10)->Range(min_objects, max_objects)->Unit(benchmark::kMillisecond)
+
+#define JSON_CGAL_BENCHMARK_ALL_TYPES(function)                  \
+	JSON_CGAL_BENCHMARK(function, JsonCGAL::Point_2d);            \
+	JSON_CGAL_BENCHMARK(function, JsonCGAL::Line_2d);             \
+	JSON_CGAL_BENCHMARK(function, JsonCGAL::Segment_2d);          \
+	JSON_CGAL_BENCHMARK(function, JsonCGAL::Weighted_point_2d);   \
+	JSON_CGAL_BENCHMARK(function, JsonCGAL::Vector_2d);           \
+	JSON_CGAL_BENCHMARK(function, JsonCGAL::Direction_2d);        \
+	JSON_CGAL_BENCHMARK(function, JsonCGAL::Ray_2d);              \
+	JSON_CGAL_BENCHMARK(function, JsonCGAL::Triangle_2d);         \
+	JSON_CGAL_BENCHMARK(function, JsonCGAL::Iso_rectangle_2d);    \
+	JSON_CGAL_BENCHMARK(function, JsonCGAL::Circle_2d)
+
+#define JSON_CGAL_BENCHMARK_JSON_DATASETS(function) \
+	JSON_CGAL_BENCHMARK(function, Points);           \
+	JSON_CGAL_BENCHMARK(function, Segments);         \
+	JSON_CGAL_BENCHMARK(function, Lines);            \
+	JSON_CGAL_BENCHMARK(function, Mixed)
+
+JSON_CGAL_BENCHMARK_JSON_DATASETS(BM_LoadFromString);
+JSON_CGAL_BENCHMARK_JSON_DATASETS(BM_Load);
+BENCHMARK(BM_LoadJsonLines)->ArgsProduct({{min_objects, max_objects}, {0, 1}})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ForEachPoint)->RangeMultiplier(10)->Range(min_objects, max_objects)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LazyLoadSegmentsFromMixed)->RangeMultiplier(10)->Range(min_objects, max_objects)->Unit(benchmark::kMillisecond);
+JSON_CGAL_BENCHMARK_JSON_DATASETS(BM_DumpToString);
+JSON_CGAL_BENCHMARK_JSON_DATASETS(BM_Dump);
+BENCHMARK(BM_DumpGzip)->ArgsProduct({{min_objects, max_objects / 10}, {1, 0}})->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_PointCloudRoundTrip, CGAL::Simple_cartesian<double>)->ArgsProduct({{min_objects, max_objects}, {0, 1}})->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_PointCloudRoundTrip, Float_kernel)->ArgsProduct({{min_objects, max_objects}, {0, 1}})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_QuerySegments)->ArgsProduct({{min_objects, max_objects}, {0, 1}})->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_LoadRegion)->ArgsProduct({{min_objects, max_objects}, {0, 1}})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LoadTiledRegion)->ArgsProduct({{min_objects, max_objects}, {0, 1}})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LoadTiled)->ArgsProduct({{min_objects, max_objects}, {1, 0}})->Unit(benchmark::kMillisecond);
+JSON_CGAL_BENCHMARK_ALL_TYPES(BM_BinaryLoadFromString);
+JSON_CGAL_BENCHMARK_ALL_TYPES(BM_BinaryDumpToString);
+JSON_CGAL_BENCHMARK_ALL_TYPES(BM_AddObjects);
+JSON_CGAL_BENCHMARK_ALL_TYPES(BM_GetObjects);
+JSON_CGAL_BENCHMARK_ALL_TYPES(BM_View);
+
+BENCHMARK_MAIN();
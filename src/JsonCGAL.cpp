@@ -15,161 +15,2625 @@
 #include <string>
 #include <iostream>
 #include <map>
+#include <sstream>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <filesystem>
+#include <limits>
+
+#include <CGAL/intersections.h>
 
 #include "JsonCGAL.h"
 #include "JsonCGALMap.h"
+#include "JsonCGALBinary.h"
+#include "JsonCGALStreams.h"
+#include "JsonCGALMappedFile.h"
+#include "JsonCGALWriter.h"
+#include "JsonCGALScanner.h"
+#include "JsonCGALReader.h"
+#include "JsonCGALReadAhead.h"
+#include "JsonCGALCompression.h"
 #include "json.hpp"
 
 namespace JsonCGAL
 {
 	/**
-	* \brief parse a json data field into the appropriate class list
+	 * \brief sink that stores decoded objects in the container object stores
+	 */
+	template <class K>
+	class ObjectStoreSink : public GeometrySink
+	{
+		public:
+			explicit ObjectStoreSink(BasicJsonCGAL<K> &container) : _container(container) {}
+
+			bool add(SupportedTypes::SupportedTypes type, const double *coordinates, std::size_t count)
+			{
+				return _container.add_coordinates(type, coordinates, count);
+			}
+
+			bool add_flat(SupportedTypes::SupportedTypes type, const double *values, std::size_t count)
+			{
+				return _container.add_flat(type, values, count);
+			}
+
+			bool add_columns(SupportedTypes::SupportedTypes type, const double *const *columns, std::size_t rows)
+			{
+				return _container.add_columns(type, columns, rows);
+			}
+
+		private:
+			BasicJsonCGAL<K> &_container;
+	};
+
+	/* objects decoded before a batch is handed over when streaming a file */
+	static const std::size_t stream_batch_size = 4096;
+
+	/**
+	 * \brief sink that collects decoded objects into batches and hands each
+	 *        full batch to a visitor. The first skip objects are dropped, so
+	 *        a parse can be restarted after objects were handed over.
+	 */
+	template <class K>
+	class ObjectStreamSink : public GeometrySink
+	{
+		public:
+			ObjectStreamSink(BasicJsonCGAL<K> &batch, const typename BasicJsonCGAL<K>::BatchVisitor &visit, std::size_t skip)
+				: _batch(batch), _store(batch), _visit(visit), _skip(skip) {}
+
+			bool add(SupportedTypes::SupportedTypes type, const double *coordinates, std::size_t count)
+			{
+				if (this->_skip > 0)
+				{
+					this->_skip--;
+					return true;
+				}
+				return this->_store.add(type, coordinates, count) && this->flush_full();
+			}
+
+			bool add_flat(SupportedTypes::SupportedTypes type, const double *values, std::size_t count)
+			{
+				if (this->_skip > 0)
+				{
+					this->_skip--;
+					return true;
+				}
+				return this->_store.add_flat(type, values, count) && this->flush_full();
+			}
+
+			bool add_columns(SupportedTypes::SupportedTypes type, const double *const *columns, std::size_t rows)
+			{
+				std::size_t skipped = (this->_skip < rows) ? this->_skip : rows;
+				const double *remaining[max_type_columns];
+				for (std::size_t column = 0; column < type_column_counts[type]; column++)
+				{
+					remaining[column] = columns[column] + skipped;
+				}
+				this->_skip -= skipped;
+				return this->_store.add_columns(type, remaining, rows - skipped) && this->flush_full();
+			}
+
+			/**
+			* \brief hand over the objects left in the batch
+			*
+			* \return number of objects handed over since the sink was made
+			*/
+			std::size_t finish()
+			{
+				if (this->_batch.size() > 0)
+				{
+					this->_delivered += this->_batch.size();
+					this->_batch.flush_batch(this->_visit);
+				}
+				return this->_delivered;
+			}
+
+			/* number of objects handed over, not counting those still in the batch */
+			std::size_t delivered() const { return this->_delivered; }
+
+		private:
+			bool flush_full()
+			{
+				if (this->_batch.size() >= stream_batch_size)
+				{
+					this->finish();
+				}
+				return true;
+			}
+
+			BasicJsonCGAL<K> &_batch;
+			ObjectStoreSink<K> _store;
+			const typename BasicJsonCGAL<K>::BatchVisitor &_visit;
+			std::size_t _skip;
+			std::size_t _delivered = 0;
+	};
+
+	/**
+	* \brief test whether a box overlaps a region, boundary included
+	*/
+	static bool box_in_region(double xmin, double ymin, double xmax, double ymax, const CGAL::Bbox_2 &region)
+	{
+		return xmin <= region.xmax() && region.xmin() <= xmax && ymin <= region.ymax() && region.ymin() <= ymax;
+	}
+
+	/**
+	* \brief test whether the points (x, y) + t (dx, dy) with t in [0, last]
+	*        reach into a region
+	*/
+	static bool clip_to_region(double x, double y, double dx, double dy, double last, const CGAL::Bbox_2 &region)
+	{
+		double first = 0.0;
+		double denominators[4] = {-dx, dx, -dy, dy};
+		double distances[4] = {x - region.xmin(), region.xmax() - x, y - region.ymin(), region.ymax() - y};
+		for (int i = 0; i < 4; i++)
+		{
+			if (denominators[i] == 0.0)
+			{
+				if (distances[i] < 0.0)
+				{
+					return false;
+				}
+				continue;
+			}
+			double t = distances[i] / denominators[i];
+			if (denominators[i] < 0.0)
+			{
+				first = (t > first) ? t : first;
+			}
+			else
+			{
+				last = (t < last) ? t : last;
+			}
+		}
+		return first <= last;
+	}
+
+	/**
+	* \brief bounding box of a bounded object given by its flat coordinate layout
 	*
-	* \param container, a json geometry container
+	* \param type, the object type
+	* \param values, the flat coordinate values of the object
+	* \param box, receives xmin, ymin, xmax, ymax
+	* \return false for lines, rays, vectors and directions, which have no bounding box
 	*/
-	void JsonCGAL::parse_json_container(nlohmann::json container)
-	{		
-		/* containers */
-		std::vector<double> coordinates;
-		CGAL_list<Point_2d> points;
-		std::string datatype;
-		nlohmann::json field;
-		nlohmann::json point;
-		nlohmann::json points_container;
+	static bool flat_box(SupportedTypes::SupportedTypes type, const double *values, double box[4])
+	{
+		switch (type)
+		{
+		case SupportedTypes::point_2:
+		case SupportedTypes::weighted_point_2:
+			box[0] = box[2] = values[0];
+			box[1] = box[3] = values[1];
+			return true;
+
+		case SupportedTypes::segment_2:
+		case SupportedTypes::iso_rectangle_2:
+			box[0] = std::min(values[0], values[2]);
+			box[1] = std::min(values[1], values[3]);
+			box[2] = std::max(values[0], values[2]);
+			box[3] = std::max(values[1], values[3]);
+			return true;
 
-		/* iterate over the json container */
-		for (nlohmann::json::iterator it = container.begin(); it < container.end(); it++)
+		case SupportedTypes::triangle_2:
+			box[0] = std::min({values[0], values[2], values[4]});
+			box[1] = std::min({values[1], values[3], values[5]});
+			box[2] = std::max({values[0], values[2], values[4]});
+			box[3] = std::max({values[1], values[3], values[5]});
+			return true;
+
+		case SupportedTypes::circle_2:
 		{
-			field = *it;
-         this->_objs.push_back(JsonCGALBase::object_factory(field));
+			double radius = std::sqrt(values[2]);
+			box[0] = values[0] - radius;
+			box[1] = values[1] - radius;
+			box[2] = values[0] + radius;
+			box[3] = values[1] + radius;
+			return true;
+		}
+
+		default:
+			return false;
 		}
-		return;
 	}
 
 	/**
-	* \brief pack a json geometry object into a json array container
+	* \brief test whether an object, given by its flat coordinate layout,
+	*        reaches into a region. Bounded objects are tested by their
+	*        bounding box, lines and rays by clipping them to the region.
+	*        Vectors and directions have no position and are never inside.
 	*
-	* \returns a json geometry container
+	* \param type, the object type
+	* \param values, the flat coordinate values of the object
+	* \param region, the region to test against
+	* \return true if the object should be kept
 	*/
-	nlohmann::json JsonCGAL::create_json_container()
+	static bool flat_in_region(SupportedTypes::SupportedTypes type, const double *values, const CGAL::Bbox_2 &region)
 	{
-		/* create the container as an empty array */
-		nlohmann::json container = nlohmann::json::array();
-      JsonCGALBase *obj;
-      for (CGAL_list<JsonCGALBase*>::iterator it = this->_objs.begin(); it < this->_objs.end(); it++)
-      {
-         obj = *it;
-         container.push_back(obj->encode());
-      }
-		return container;
+		double box[4];
+		if (flat_box(type, values, box))
+		{
+			return box_in_region(box[0], box[1], box[2], box[3], region);
+		}
+		switch (type)
+		{
+		case SupportedTypes::line_2:
+		{
+			/* the line crosses the region unless every corner is strictly on one side */
+			bool above = false;
+			bool below = false;
+			double xs[2] = {region.xmin(), region.xmax()};
+			double ys[2] = {region.ymin(), region.ymax()};
+			for (double x : xs)
+			{
+				for (double y : ys)
+				{
+					double side = values[0] * x + values[1] * y + values[2];
+					above = above || side >= 0.0;
+					below = below || side <= 0.0;
+				}
+			}
+			return above && below;
+		}
+
+		case SupportedTypes::ray_2:
+			return clip_to_region(values[0], values[1], values[2] - values[0], values[3] - values[1], std::numeric_limits<double>::infinity(), region);
+
+		default:
+			return false;
+		}
 	}
 
+	/**
+	 * \brief points the region of a container at the bounds of a region load,
+	 *        and clears it again when the load returns or throws
+	 */
+	class RegionScope
+	{
+		public:
+			RegionScope(const CGAL::Bbox_2 *&region, const CGAL::Bbox_2 &bounds) : _region(region) { _region = &bounds; }
+			~RegionScope() { _region = nullptr; }
+			RegionScope(const RegionScope &) = delete;
+			RegionScope &operator=(const RegionScope &) = delete;
+
+		private:
+			const CGAL::Bbox_2 *&_region;
+	};
 
 	/**
-		* \brief parse a json geometry file into a json geometry object
-		*
-		* \param filename, the string filename to open
-		* \return success/failure
+	* \brief construct an object from its type and the flat list of coordinates
+	*        found in its json "coordinates" fields, and append it to its store.
+	*        Only points, segments and lines have a nested encoding, so only they
+	*        are tested against the region here. Every other type is written
+	*        compact and arrives through add_flat, which tests all types.
+	*
+	* \param type, the object type
+	* \param coordinates, pointer to the coordinate values
+	* \param count, number of coordinate values
+	* \return false if the coordinates do not fit the type
 	*/
-	bool JsonCGAL::load(std::string filename)
+	template <class K>
+	bool BasicJsonCGAL<K>::add_coordinates(SupportedTypes::SupportedTypes type, const double *coordinates, std::size_t count)
 	{
-		nlohmann::json json_data;
-		std::ifstream infile;
-		infile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-		try
+		if (this->_region != nullptr && count == 2 * (type == SupportedTypes::point_2 ? 1 : 2))
+		{
+			/* lines are given by two points, tested in their a, b, c layout */
+			double line[3];
+			const double *values = coordinates;
+			if (type == SupportedTypes::line_2)
+			{
+				line[0] = coordinates[1] - coordinates[3];
+				line[1] = coordinates[2] - coordinates[0];
+				line[2] = coordinates[0] * coordinates[3] - coordinates[1] * coordinates[2];
+				values = line;
+			}
+			if ((type == SupportedTypes::point_2 || type == SupportedTypes::segment_2 || type == SupportedTypes::line_2) &&
+			    !flat_in_region(type, values, *this->_region))
+			{
+				this->_filtered++;
+				return true;
+			}
+		}
+
+		switch (type)
 		{
-			infile.open(filename.c_str());
+		case SupportedTypes::point_2:
+			if (count != 2)
+			{
+				return false;
+			}
+			this->store<Point_2d>().emplace_back(coordinates[0], coordinates[1]);
+			break;
 
-			try
+		case SupportedTypes::segment_2:
+			if (count != 4)
 			{
-				infile >> json_data;
+				return false;
 			}
-			catch (nlohmann::json::parse_error& e)
+			this->store<Segment_2d>().emplace_back(Point_2d(coordinates[0], coordinates[1]), Point_2d(coordinates[2], coordinates[3]));
+			break;
+
+		case SupportedTypes::line_2:
+			if (count != 4)
 			{
-				/* caught invalid json formatting error */
-				std::cout << "message: " << e.what() << '\n'
-						  << "exception id: " << e.id << '\n'
-						  << "byte position of error: " << e.byte << std::endl;
 				return false;
 			}
+			this->store<Line_2d>().emplace_back(Point_2d(coordinates[0], coordinates[1]), Point_2d(coordinates[2], coordinates[3]));
+			break;
 
-			this->parse_json_container(json_data);
+		default:
+			std::cerr << "JsonCGAL Error: invalid object type specifier" << std::endl;
+			this->store<Point_2d>().emplace_back();
+			type = SupportedTypes::point_2;
+			break;
 		}
-		catch (std::ifstream::failure except)
+		this->append_order(type, 1);
+		return true;
+	}
+
+	/**
+	* \brief construct an object from its type and flat coordinate layout, as
+	*        found in the compact json schema, and append it to its store
+	*
+	* \param type, the object type
+	* \param values, pointer to the flat coordinate values
+	* \param count, number of values
+	* \return false if the number of values does not fit the type
+	*/
+	template <class K>
+	bool BasicJsonCGAL<K>::add_flat(SupportedTypes::SupportedTypes type, const double *values, std::size_t count)
+	{
+		bool added = false;
+		bool kept = false;
+		this->visit_store(type, [&](auto &store)
 		{
-			/* TODO: print the exception details*/
-			std::cout << "Exception while loading file " << std::endl;
-			return false;
+			typedef typename std::decay<decltype(store)>::type::value_type T;
+			if (count == T::coordinate_count)
+			{
+				added = true;
+				kept = this->_region == nullptr || flat_in_region(type, values, *this->_region);
+				if (kept)
+				{
+					store.push_back(T::unflatten(values));
+				}
+			}
+		});
+		if (kept)
+		{
+			this->append_order(type, 1);
+		}
+		else if (added)
+		{
+			this->_filtered++;
 		}
+		return added;
+	}
+
+	/**
+	* \brief append a block of objects of one type from the parallel value
+	*        columns of their flat coordinate layout
+	*
+	* \param type, the object type
+	* \param columns, one array of rows values per value of the flat layout
+	* \param rows, number of objects
+	* \return success
+	*/
+	template <class K>
+	bool BasicJsonCGAL<K>::add_columns(SupportedTypes::SupportedTypes type, const double *const *columns, std::size_t rows)
+	{
+		std::size_t kept = 0;
+		this->visit_store(type, [&](auto &store)
+		{
+			typedef typename std::decay<decltype(store)>::type::value_type T;
+			double values[T::coordinate_count];
+			if (this->_region == nullptr)
+			{
+				reserve_additional(store, rows);
+			}
+			for (std::size_t row = 0; row < rows; row++)
+			{
+				for (std::size_t column = 0; column < T::coordinate_count; column++)
+				{
+					values[column] = columns[column][row];
+				}
+				if (this->_region == nullptr || flat_in_region(type, values, *this->_region))
+				{
+					store.push_back(T::unflatten(values));
+					kept++;
+				}
+			}
+		});
+		this->append_order(type, kept);
+		this->_filtered += rows - kept;
 		return true;
 	}
 
 	/**
-	 * \brief parse input from a json string stream
-	 * 
-	 * \param json_string 
-	 * \return true 
-	 * \return false 
-	 */
-	bool JsonCGAL::load_from_string(std::string json_string)
+	* \brief record that count objects of a type were appended to its store
+	*
+	* \param type, the object type
+	* \param count, number of objects appended
+	*/
+	template <class K>
+	void BasicJsonCGAL<K>::append_order(SupportedTypes::SupportedTypes type, std::size_t count)
 	{
-		nlohmann::json json_data;
-		try
+		if (count == 0)
 		{
-			json_data = nlohmann::json::parse(json_string);
+			return;
 		}
-		catch (nlohmann::json::parse_error& e)
+		if (!this->_order.empty() && this->_order.back().type == type)
 		{
-			/* caught invalid json formatting error */
-			std::cout << "message: " << e.what() << '\n'
-						<< "exception id: " << e.id << '\n'
-						<< "byte position of error: " << e.byte << std::endl;
+			this->_order.back().count += count;
+		}
+		else
+		{
+			this->_order.push_back({type, count});
+		}
+		this->_size += count;
+		this->_spatial.reset();
+	}
+
+	/**
+	* \brief number of stored objects of a type
+	*
+	* \param type, the object type
+	* \return object count
+	*/
+	template <class K>
+	std::size_t BasicJsonCGAL<K>::count(SupportedTypes::SupportedTypes type) const
+	{
+		std::size_t count = 0;
+		this->visit_store(type, [&](const auto &store) { count = store.size(); });
+		return count + this->_pending[type].count;
+	}
+
+	/**
+	* \brief remove every object and release the store memory, one block per type
+	*/
+	template <class K>
+	void BasicJsonCGAL<K>::clear()
+	{
+		for (std::size_t type = 0; type < supported_type_count; type++)
+		{
+			this->visit_store(static_cast<SupportedTypes::SupportedTypes>(type), [](auto &store)
+			{
+				typename std::decay<decltype(store)>::type empty;
+				store.swap(empty);
+			});
+		}
+		CGAL_list<ObjectRun>().swap(this->_order);
+		this->_size = 0;
+		for (std::size_t type = 0; type < supported_type_count; type++)
+		{
+			this->_pending[type] = PendingObjects();
+		}
+		this->_spatial.reset();
+	}
+
+	/**
+	* \brief snapshot the container sizes. Decoded objects and lazily loaded
+	*        objects still held as text are recorded apart.
+	*/
+	template <class K>
+	typename BasicJsonCGAL<K>::Mark BasicJsonCGAL<K>::mark() const
+	{
+		Mark mark;
+		for (std::size_t type = 0; type < supported_type_count; type++)
+		{
+			this->visit_store(static_cast<SupportedTypes::SupportedTypes>(type), [&](const auto &store) { mark.sizes[type] = store.size(); });
+			mark.pending[type] = this->_pending[type].count;
+			mark.pending_runs[type] = this->_pending[type].runs.size();
+		}
+		mark.runs = this->_order.size();
+		mark.last_run_count = this->_order.empty() ? 0 : this->_order.back().count;
+		mark.filtered = this->_filtered;
+		return mark;
+	}
+
+	/**
+	* \brief discard every object added since a snapshot was taken, including
+	*        json text indexed by a lazy load since then
+	*
+	* \param mark, the snapshot to return to
+	*/
+	template <class K>
+	void BasicJsonCGAL<K>::rollback(const Mark &mark)
+	{
+		this->_size = 0;
+		for (std::size_t type = 0; type < supported_type_count; type++)
+		{
+			PendingObjects &pending = this->_pending[type];
+			std::size_t kept = mark.sizes[type];
+			if (pending.count >= mark.pending[type])
+			{
+				/* runs are only appended, so the text indexed since the mark is at the end */
+				pending.runs.resize(mark.pending_runs[type]);
+				pending.count = mark.pending[type];
+				if (pending.count == 0)
+				{
+					pending = PendingObjects();
+				}
+			}
+			else
+			{
+				/* decoded since the mark, the decoded objects follow the marked ones */
+				kept += mark.pending[type];
+			}
+			this->visit_store(static_cast<SupportedTypes::SupportedTypes>(type), [&](auto &store)
+			{
+				store.resize(std::min(store.size(), kept));
+				this->_size += store.size();
+			});
+			this->_size += pending.count;
+		}
+
+		this->_order.resize(mark.runs);
+		if (!this->_order.empty())
+		{
+			this->_order.back().count = mark.last_run_count;
+		}
+		this->_filtered = mark.filtered;
+		this->_spatial.reset();
+	}
+
+	/**
+	* \brief parse a json geometry array from an input stream straight into
+	*        the object stores using SAX events (no intermediate DOM). On failure
+	*        any objects decoded from the stream are discarded.
+	*
+	* \param input, the json input to parse
+	* \return success/failure
+	*/
+	template <class K>
+	bool BasicJsonCGAL<K>::parse_json_stream(nlohmann::detail::input_adapter &&input)
+	{
+		Mark start = this->mark();
+		ObjectStoreSink<K> sink(*this);
+		GeometrySaxHandler handler(sink);
+
+		if (!nlohmann::json::sax_parse(std::move(input), &handler))
+		{
+			handler.print_error();
+			this->rollback(start);
 			return false;
 		}
-		this->parse_json_container(json_data);
 		return true;
 	}
 
 	/**
-		* \brief dump a json geometry object into a file
-		*
-		* \param filename, the string filename/path to record to
-		* \return success/failure
+	* \brief parse json text held in memory with the geometry specialized
+	*        reader, falling back to the general parser for text it does not
+	*        accept (escaped strings, errors) so errors are still reported.
+	*
+	* \param data, start of the json text
+	* \param size, number of bytes of json text
+	* \return success/failure
 	*/
-	bool JsonCGAL::dump(std::string filename)
+	template <class K>
+	bool BasicJsonCGAL<K>::parse_json_buffer(const char *data, std::size_t size)
 	{
-		nlohmann::json container;
-		std::ofstream outfile;
-		outfile.exceptions(std::ofstream::failbit | std::ofstream::badbit);
-		try
+		Mark start = this->mark();
+		ObjectStoreSink<K> sink(*this);
+		GeometrySaxHandler handler(sink);
+		JsonReader reader(data, size);
+
+		if (reader.parse(handler))
+		{
+			return true;
+		}
+		this->rollback(start);
+		return this->parse_json_stream(nlohmann::detail::input_adapter(data, size));
+	}
+
+	/**
+	* \brief parse a comma separated list of json array elements, e.g. a slice
+	*        from split_json_array, appending the objects in order. On failure
+	*        any objects decoded from the slice are discarded.
+	*
+	* \param data, start of the first element
+	* \param size, number of bytes up to the end of the last element
+	* \param report_errors, print the parser error on failure
+	* \return success/failure
+	*/
+	template <class K>
+	bool BasicJsonCGAL<K>::parse_json_elements(const char *data, std::size_t size, bool report_errors)
+	{
+		Mark start = this->mark();
+		ObjectStoreSink<K> sink(*this);
+		GeometrySaxHandler handler(sink);
+		JsonReader reader(data, size, ReadLayout::array_elements);
+
+		if (reader.parse(handler))
+		{
+			return true;
+		}
+		/* text the fast reader does not accept, e.g. escaped strings */
+		this->rollback(start);
+		ArraySliceStreamBuffer buffer(data, size);
+		std::istream input(&buffer);
+		GeometrySaxHandler fallback(sink);
+		if (nlohmann::json::sax_parse(input, &fallback))
+		{
+			return true;
+		}
+		if (report_errors)
 		{
-			outfile.open(filename.c_str());
+			fallback.print_error();
+		}
+		this->rollback(start);
+		return false;
+	}
 
-			/* make the container an empty array */
-			container = this->create_json_container();
+	/* bytes of json lines read from a stream at a time */
+	static const std::size_t json_lines_block_size = 1 << 20;
 
-			outfile << std::setw(4) << container << std::endl;
+	/**
+	* \brief parse json lines held in memory, one geometry object per line.
+	*        The lines are read in one pass, and only if that fails line by
+	*        line to find the line in error. On failure any objects decoded
+	*        from the text are discarded.
+	*
+	* \param data, start of the first line
+	* \param size, number of bytes of text
+	* \param line_number, number of the first line, advanced past the text
+	* \param final, true if the text ends the input. An unterminated last
+	*        line that does not parse is then taken as an interrupted write,
+	*        and skipped with a warning. Text without any complete line is
+	*        rejected.
+	* \return success/failure
+	*/
+	template <class K>
+	bool BasicJsonCGAL<K>::parse_json_lines(const char *data, std::size_t size, std::size_t &line_number, bool final)
+	{
+		const char *end = data + size;
+		const char *tail = end;
+		if (final)
+		{
+			while (tail > data && tail[-1] != '\n')
+			{
+				tail--;
+			}
+		}
 
+		Mark start = this->mark();
+		ObjectStoreSink<K> sink(*this);
+		GeometrySaxHandler handler(sink);
+		JsonReader reader(data, static_cast<std::size_t>(tail - data), ReadLayout::lines);
+		if (!reader.parse(handler))
+		{
+			this->rollback(start);
+			for (const char *line = data; line < tail; line_number++)
+			{
+				const char *line_end = std::find(line, tail, '\n');
+				std::size_t objects = this->_size + this->_filtered;
+				if (skip_json_whitespace(line, line_end) != line_end &&
+				    (!this->parse_json_elements(line, static_cast<std::size_t>(line_end - line), true) || this->_size + this->_filtered != objects + 1))
+				{
+					std::cerr << "JsonCGAL Error: invalid geometry object on json line " << line_number << std::endl;
+					this->rollback(start);
+					return false;
+				}
+				line = line_end + 1;
+			}
 		}
-		catch (std::ofstream::failure except)
+		else
 		{
-			/* TODO: print the exception trace */
-			std::cout << "Exception while dumping to file " << std::endl;
-			return false;
+			line_number += static_cast<std::size_t>(std::count(data, tail, '\n'));
+		}
+
+		if (skip_json_whitespace(tail, end) != end)
+		{
+			if (line_number == 1)
+			{
+				/* a lone object without a newline is not json lines, and not a valid document either */
+				std::cerr << "JsonCGAL Error: json lines text has no complete line" << std::endl;
+				this->rollback(start);
+				return false;
+			}
+			Mark line_start = this->mark();
+			std::size_t objects = this->_size + this->_filtered;
+			if (!this->parse_json_elements(tail, static_cast<std::size_t>(end - tail), false) || this->_size + this->_filtered != objects + 1)
+			{
+				this->rollback(line_start);
+				std::cerr << "JsonCGAL Warning: skipping incomplete json line " << line_number << std::endl;
+			}
 		}
 		return true;
 	}
 
 	/**
-	* \brief dump a json geometry object to a string
+	* \brief parse json lines from a stream, holding at most a block of text
+	*        (or one longer line) in memory at a time
 	*
-	* \param filename, the string filename/path to record to
+	* \param input, the stream to read
+	* \param visit, if set the objects of each block are handed to it and
+	*        dropped, instead of kept in the container
 	* \return success/failure
 	*/
-	std::string JsonCGAL::dump_to_string()
+	template <class K>
+	bool BasicJsonCGAL<K>::parse_json_lines_stream(std::istream &input, const BatchVisitor *visit)
 	{
-		nlohmann::json container = this->create_json_container();
-		std::string output = container.dump(4);
-		return output;
+		Mark start = this->mark();
+		std::string block(json_lines_block_size, '\0');
+		std::size_t held = 0;
+		std::size_t line_number = 1;
+		for (;;)
+		{
+			if (held == block.size())
+			{
+				/* a line longer than the block */
+				block.resize(2 * block.size());
+			}
+			std::size_t read = static_cast<std::size_t>(input.rdbuf()->sgetn(&block[held], static_cast<std::streamsize>(block.size() - held)));
+			held += read;
+			if (read == 0)
+			{
+				break;
+			}
+			/* parse the complete lines and keep the rest for the next block */
+			std::size_t complete = block.rfind('\n', held - 1);
+			if (complete == std::string::npos)
+			{
+				continue;
+			}
+			complete++;
+			if (!this->parse_json_lines(block.data(), complete, line_number, false))
+			{
+				this->rollback(start);
+				return false;
+			}
+			if (visit != nullptr)
+			{
+				this->flush_batch(*visit);
+			}
+			std::copy(block.begin() + complete, block.begin() + held, block.begin());
+			held -= complete;
+		}
+		if (!this->parse_json_lines(block.data(), held, line_number, true))
+		{
+			this->rollback(start);
+			return false;
+		}
+		if (visit != nullptr)
+		{
+			this->flush_batch(*visit);
+		}
+		return true;
 	}
+
+	/**
+	* \brief index a json array of geometry objects by type without decoding
+	*        it. Each type is decoded from the text on its first access.
+	*
+	* \param source, owner of the json text, kept until every type is decoded
+	* \param data, start of the json text
+	* \param size, number of bytes of json text
+	* \return false if the text cannot be indexed and has to be parsed
+	*/
+	template <class K>
+	bool BasicJsonCGAL<K>::index_json_buffer(const std::shared_ptr<const void> &source, const char *data, std::size_t size)
+	{
+		std::vector<ElementRun> runs;
+		if (!index_json_array(data, size, runs))
+		{
+			return false;
+		}
+		std::vector<SupportedTypes::SupportedTypes> types(runs.size());
+		for (std::size_t i = 0; i < runs.size(); i++)
+		{
+			std::string_view key(data + runs[i].type.begin, runs[i].type.end - runs[i].type.begin);
+			if (!find_type(key, types[i]))
+			{
+				return false;
+			}
+		}
+
+		for (std::size_t i = 0; i < runs.size(); i++)
+		{
+			PendingObjects &pending = this->_pending[types[i]];
+			pending.source = source;
+			pending.text = data;
+			pending.runs.push_back(runs[i].elements);
+			pending.count += runs[i].count;
+			this->append_order(types[i], runs[i].count);
+		}
+		return true;
+	}
+
+	/**
+	* \brief decode the lazily loaded objects of a type into its store. If the
+	*        text turns out to be invalid the error is printed and the objects
+	*        are dropped. Only mutable members are changed, so this is callable
+	*        from const accessors, but not from several threads at once.
+	*
+	* \param type, the object type
+	* \return false if the objects failed to decode and were dropped
+	*/
+	template <class K>
+	bool BasicJsonCGAL<K>::decode_pending(SupportedTypes::SupportedTypes type) const
+	{
+		/* read only when nothing is pending, so eagerly loaded containers are safe to share */
+		if (this->_pending[type].count == 0)
+		{
+			return true;
+		}
+		PendingObjects pending;
+		std::swap(pending, this->_pending[type]);
+
+		/* one handler reads every run, a run it does not accept restarts the
+		   decode run by run so the general parser can take over */
+		BasicJsonCGAL decoded;
+		ObjectStoreSink<K> sink(decoded);
+		GeometrySaxHandler handler(sink);
+		JsonReader reader(pending.text, 0, ReadLayout::array_elements);
+		bool parsed = true;
+		for (std::size_t i = 0; i < pending.runs.size() && parsed; i++)
+		{
+			reader.reset(pending.text + pending.runs[i].begin, pending.runs[i].end - pending.runs[i].begin);
+			parsed = reader.parse(handler);
+		}
+		if (!parsed)
+		{
+			decoded.clear();
+			parsed = true;
+			for (std::size_t i = 0; i < pending.runs.size() && parsed; i++)
+			{
+				parsed = decoded.parse_json_elements(pending.text + pending.runs[i].begin, pending.runs[i].end - pending.runs[i].begin, true);
+			}
+		}
+		BasicJsonCGAL &self = const_cast<BasicJsonCGAL &>(*this);
+		if (!parsed || decoded.size() != pending.count || decoded.count(type) != pending.count)
+		{
+			if (parsed)
+			{
+				std::cerr << "JsonCGAL Error: lazily loaded objects do not match their type key " << type_key(type) << std::endl;
+			}
+			self.drop_last_objects(type, pending.count);
+			return false;
+		}
+		self.visit_store(type, [&](auto &store)
+		{
+			typedef typename std::decay<decltype(store)>::type::value_type T;
+			CGAL_list<T> &source = decoded.store<T>();
+			if (store.empty())
+			{
+				store.swap(source);
+			}
+			else
+			{
+				store.insert(store.end(), std::make_move_iterator(source.begin()), std::make_move_iterator(source.end()));
+			}
+		});
+		return true;
+	}
+
+	/**
+	* \brief decode every lazily loaded type
+	*
+	* \return false if any type failed to decode and its objects were dropped
+	*/
+	template <class K>
+	bool BasicJsonCGAL<K>::decode_all_pending() const
+	{
+		bool decoded = true;
+		for (std::size_t type = 0; type < supported_type_count; type++)
+		{
+			decoded = this->decode_pending(static_cast<SupportedTypes::SupportedTypes>(type)) && decoded;
+		}
+		return decoded;
+	}
+
+	/**
+	* \brief decode every type a lazy load left as text. Objects of a type that
+	*        fails to decode are dropped, as on their first access. Call this
+	*        before reading a lazily loaded container from several threads.
+	*
+	* \return false if any type failed to decode
+	*/
+	template <class K>
+	bool BasicJsonCGAL<K>::decode_all()
+	{
+		return this->decode_all_pending();
+	}
+
+	/**
+	* \brief remove the last objects of a type from the insertion order, used
+	*        when lazily loaded objects fail to decode
+	*
+	* \param type, the object type
+	* \param count, number of objects to remove
+	*/
+	template <class K>
+	void BasicJsonCGAL<K>::drop_last_objects(SupportedTypes::SupportedTypes type, std::size_t count) const
+	{
+		std::size_t remaining = count;
+		for (std::size_t run = this->_order.size(); run-- > 0 && remaining > 0;)
+		{
+			if (this->_order[run].type == type)
+			{
+				std::size_t removed = (this->_order[run].count < remaining) ? this->_order[run].count : remaining;
+				this->_order[run].count -= removed;
+				remaining -= removed;
+			}
+		}
+
+		/* drop the emptied runs and join the neighbours they separated */
+		CGAL_list<ObjectRun> order;
+		for (typename CGAL_list<ObjectRun>::iterator run = this->_order.begin(); run < this->_order.end(); run++)
+		{
+			if (run->count == 0)
+			{
+				continue;
+			}
+			if (!order.empty() && order.back().type == run->type)
+			{
+				order.back().count += run->count;
+			}
+			else
+			{
+				order.push_back(*run);
+			}
+		}
+		this->_order.swap(order);
+		this->_size -= count - remaining;
+		std::atomic_store(&this->_spatial, std::shared_ptr<const SpatialObjects>());
+	}
+
+	/* size at which buffered json text is flushed to the output stream */
+	static const std::size_t json_flush_size = 1 << 20;
+
+	/* objects each thread encodes per batch when dumping in parallel */
+	static const std::size_t parallel_dump_block = 16384;
+
+	/**
+	* \brief write an object in the compact schema, as its type key and its
+	*        flat coordinate layout
+	*/
+	template <class Number, class T>
+	static void write_compact_object(JsonWriter &writer, const T &object)
+	{
+		double values[T::coordinate_count];
+		object.flatten(values);
+		writer.begin_array(true);
+		writer.value(type_traits<T>::key);
+		writer.begin_array();
+		for (std::size_t i = 0; i < T::coordinate_count; i++)
+		{
+			writer.value(static_cast<Number>(values[i]));
+		}
+		writer.end_array();
+		writer.end_array();
+	}
+
+	/**
+	* \brief write the objects at positions [first, last) of the insertion
+	*        order as array elements. When an output stream is given the
+	*        writer buffer is flushed to it in chunks so memory stays bounded.
+	*
+	* \param writer, writer positioned inside the json array
+	* \param schema, the json layout of each object
+	* \param lines, end each object with a newline (json lines)
+	* \param first, insertion position of the first object to write
+	* \param last, insertion position one past the last object to write
+	* \param output, optional stream to flush the buffer to
+	*/
+	template <class K>
+	void BasicJsonCGAL<K>::write_json_objects(JsonWriter &writer, JsonSchema::JsonSchema schema, bool lines, std::size_t first, std::size_t last, std::ostream *output) const
+	{
+		std::size_t cursors[supported_type_count] = {};
+		std::size_t position = 0;
+		std::string &buffer = writer.output();
+		for (typename CGAL_list<ObjectRun>::const_iterator run = this->_order.begin(); run < this->_order.end() && position < last; run++)
+		{
+			std::size_t run_end = position + run->count;
+			if (run_end > first)
+			{
+				std::size_t begin = (first > position) ? first : position;
+				std::size_t end = (last < run_end) ? last : run_end;
+				std::size_t index = cursors[run->type] + (begin - position);
+				this->visit_store(run->type, [&](const auto &store)
+				{
+					for (std::size_t i = index; i < index + (end - begin); i++)
+					{
+						if (schema == JsonSchema::compact)
+						{
+							write_compact_object<number_type>(writer, store[i]);
+						}
+						else
+						{
+							store[i].write(writer);
+						}
+						if (lines)
+						{
+							buffer.push_back('\n');
+						}
+						if (output != nullptr && buffer.size() >= json_flush_size)
+						{
+							output->write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+							buffer.clear();
+						}
+					}
+				});
+			}
+			cursors[run->type] += run->count;
+			position = run_end;
+		}
+	}
+
+	/**
+	* \brief write all objects in the columnar schema, one block of value
+	*        columns per stored type in SupportedTypes order
+	*
+	* \param writer, writer to append to
+	* \param output, optional stream to flush the buffer to
+	*/
+	template <class K>
+	void BasicJsonCGAL<K>::write_json_columns(JsonWriter &writer, std::ostream *output) const
+	{
+		std::string &buffer = writer.output();
+		writer.begin_object();
+		for (std::size_t type = 0; type < supported_type_count; type++)
+		{
+			this->visit_store(static_cast<SupportedTypes::SupportedTypes>(type), [&](const auto &store)
+			{
+				typedef typename std::decay<decltype(store)>::type::value_type T;
+				double values[T::coordinate_count];
+				if (store.empty())
+				{
+					return;
+				}
+				writer.key(type_traits<T>::key);
+				writer.begin_object();
+				for (std::size_t column = 0; column < T::coordinate_count; column++)
+				{
+					writer.key(type_columns[type][column].data());
+					writer.begin_array(true);
+					for (std::size_t i = 0; i < store.size(); i++)
+					{
+						store[i].flatten(values);
+						writer.value(static_cast<number_type>(values[column]));
+						if (output != nullptr && buffer.size() >= json_flush_size)
+						{
+							output->write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+							buffer.clear();
+						}
+					}
+					writer.end_array();
+				}
+				writer.end_object();
+			});
+		}
+		writer.end_object();
+	}
+
+	/**
+	* \brief write all objects as json, appending directly to a text buffer.
+	*        With several threads the objects are encoded in batches, each
+	*        thread writing a contiguous range into its own buffer, and the
+	*        buffers are spliced in order so the text matches the serial output.
+	*        The columnar schema is always written on one thread. Json lines
+	*        are written as compact objects, one per line, with no array.
+	*
+	* \param buffer, text buffer to append to
+	* \param options, the json format, schema and indentation to write
+	* \param threads, number of encoder threads
+	* \param output, optional stream to flush the buffer to
+	*/
+	template <class K>
+	void BasicJsonCGAL<K>::write_json(std::string &buffer, const DumpOptions &options, unsigned threads, std::ostream *output) const
+	{
+		bool lines = (options.format == FileFormat::json_lines);
+		int indent = lines ? -1 : options.indent;
+		/* json lines are always compact, which encodes every supported type on one line */
+		JsonSchema::JsonSchema schema = lines ? JsonSchema::compact : options.schema;
+		if (schema == JsonSchema::columnar)
+		{
+			JsonWriter writer(buffer, indent);
+			this->write_json_columns(writer, output);
+			return;
+		}
+		if (threads <= 1 || this->_size < 2 * parallel_dump_block)
+		{
+			JsonWriter writer(buffer, indent);
+			if (!lines)
+			{
+				writer.begin_array();
+			}
+			this->write_json_objects(writer, schema, lines, 0, this->_size, output);
+			if (!lines)
+			{
+				writer.end_array();
+			}
+			return;
+		}
+
+		std::vector<std::string> buffers(threads);
+		for (std::size_t batch = 0; batch < this->_size; batch += threads * parallel_dump_block)
+		{
+			std::vector<std::thread> workers;
+			for (unsigned t = 0; t < threads; t++)
+			{
+				std::size_t first = batch + t * parallel_dump_block;
+				std::size_t last = (first + parallel_dump_block < this->_size) ? first + parallel_dump_block : this->_size;
+				buffers[t].clear();
+				if (first >= this->_size)
+				{
+					break;
+				}
+				workers.emplace_back([&, t, first, last]()
+				{
+					JsonWriter writer(buffers[t], indent);
+					if (lines)
+					{
+						this->write_json_objects(writer, schema, true, first, last, nullptr);
+						return;
+					}
+					if (first == 0)
+					{
+						writer.begin_array();
+					}
+					else
+					{
+						writer.continue_array(false);
+					}
+					this->write_json_objects(writer, schema, false, first, last, nullptr);
+					if (last == this->_size)
+					{
+						writer.end_array();
+					}
+				});
+			}
+			for (std::size_t t = 0; t < workers.size(); t++)
+			{
+				workers[t].join();
+			}
+			for (std::size_t t = 0; t < workers.size(); t++)
+			{
+				if (output != nullptr)
+				{
+					output->write(buffers[t].data(), static_cast<std::streamsize>(buffers[t].size()));
+				}
+				else
+				{
+					buffer.append(buffers[t]);
+				}
+			}
+		}
+	}
+
+	/* number of objects converted per binary read/write */
+	static const std::size_t binary_chunk_objects = 1024;
+
+	/* most objects reserved up front for one binary block, so a corrupt count cannot exhaust memory */
+	static const std::size_t binary_max_reserve = 1 << 20;
+
+	/**
+	* \brief write a run of objects as little endian values
+	*
+	* \param output, stream to write to
+	* \param store, the objects
+	* \param first, index of the first object to write
+	* \param count, number of objects to write
+	* \param indices, if set the objects written are store[indices[first]] onwards
+	*        instead of store[first] onwards
+	* \tparam Number, double or float, the type each value is written as
+	*/
+	template <class Number, class T>
+	static void write_binary_objects(std::ostream &output, const CGAL_list<T> &store, std::size_t first, std::size_t count, const std::size_t *indices = nullptr)
+	{
+		std::vector<double> values(binary_chunk_objects * T::coordinate_count);
+		std::vector<Number> numbers(std::is_same<Number, double>::value ? 0 : values.size());
+		while (count > 0)
+		{
+			std::size_t chunk = (count < binary_chunk_objects) ? count : binary_chunk_objects;
+			for (std::size_t i = 0; i < chunk; i++)
+			{
+				store[(indices != nullptr) ? indices[first + i] : first + i].flatten(&values[i * T::coordinate_count]);
+			}
+			if constexpr (std::is_same<Number, double>::value)
+			{
+				write_binary_values(output, values.data(), chunk * T::coordinate_count);
+			}
+			else
+			{
+				std::copy(values.begin(), values.begin() + chunk * T::coordinate_count, numbers.begin());
+				write_binary_values(output, numbers.data(), chunk * T::coordinate_count);
+			}
+			first += chunk;
+			count -= chunk;
+		}
+	}
+
+	/**
+	* \brief read a block of objects and append them to their store
+	*
+	* \param input, stream to read from
+	* \param store, the store to append to
+	* \param count, number of objects in the block
+	* \param region, if set only objects reaching into it are kept
+	* \param kept, receives the number of objects appended
+	* \tparam Number, double or float, the type each value was written as
+	* \return false if the stream ended early
+	*/
+	template <class Number, class T>
+	static bool read_binary_objects(std::istream &input, CGAL_list<T> &store, std::size_t count, const CGAL::Bbox_2 *region, std::size_t &kept)
+	{
+		std::vector<double> values(binary_chunk_objects * T::coordinate_count);
+		std::vector<Number> numbers(std::is_same<Number, double>::value ? 0 : values.size());
+		kept = 0;
+		if (region == nullptr)
+		{
+			reserve_additional(store, (count < binary_max_reserve) ? count : binary_max_reserve);
+		}
+		while (count > 0)
+		{
+			std::size_t chunk = (count < binary_chunk_objects) ? count : binary_chunk_objects;
+			if constexpr (std::is_same<Number, double>::value)
+			{
+				if (!read_binary_values(input, values.data(), chunk * T::coordinate_count))
+				{
+					return false;
+				}
+			}
+			else
+			{
+				if (!read_binary_values(input, numbers.data(), chunk * T::coordinate_count))
+				{
+					return false;
+				}
+				std::copy(numbers.begin(), numbers.begin() + chunk * T::coordinate_count, values.begin());
+			}
+			for (std::size_t i = 0; i < chunk; i++)
+			{
+				const double *object = &values[i * T::coordinate_count];
+				if (region == nullptr || flat_in_region(T::type_tag, object, *region))
+				{
+					store.push_back(T::unflatten(object));
+					kept++;
+				}
+			}
+			count -= chunk;
+		}
+		return true;
+	}
+
+	/**
+	* \brief write all objects in the binary geometry format
+	*
+	* \param output, stream to write to
+	*/
+	template <class K>
+	void BasicJsonCGAL<K>::write_binary_stream(std::ostream &output)
+	{
+		std::size_t cursors[supported_type_count] = {};
+		std::uint16_t flags = std::is_same<number_type, float>::value ? binary_flag_float32 : 0;
+		BinaryHeader header = {binary_version, flags, this->_order.size()};
+		write_binary_header(output, header);
+		for (typename CGAL_list<ObjectRun>::iterator run = this->_order.begin(); run < this->_order.end(); run++)
+		{
+			std::size_t &index = cursors[run->type];
+			this->visit_store(run->type, [&](const auto &store)
+			{
+				typedef typename std::decay<decltype(store)>::type::value_type T;
+				BinaryBlockHeader block = {static_cast<std::uint8_t>(run->type), T::coordinate_count, run->count};
+				write_binary_block_header(output, block);
+				write_binary_objects<number_type>(output, store, index, run->count);
+			});
+			index += run->count;
+		}
+	}
+
+	/**
+	* \brief read objects in the binary geometry format. On failure any
+	*        objects read from the stream are discarded.
+	*
+	* \param input, stream to read from
+	* \param visit, if set blocks are read a batch of objects at a time, and
+	*        each batch is handed to it and dropped instead of kept
+	* \return success/failure
+	*/
+	template <class K>
+	bool BasicJsonCGAL<K>::parse_binary_stream(std::istream &input, const BatchVisitor *visit)
+	{
+		Mark start = this->mark();
+		BinaryHeader header;
+		BinaryBlockHeader block;
+		const char *error = nullptr;
+
+		if (!read_binary_header(input, header) || header.version != binary_version || (header.flags & ~binary_known_flags) != 0)
+		{
+			error = "unsupported binary geometry header";
+		}
+		for (std::uint64_t i = 0; error == nullptr && i < header.block_count; i++)
+		{
+			if (!read_binary_block_header(input, block))
+			{
+				error = "truncated binary geometry block";
+				break;
+			}
+			if (block.type >= supported_type_count)
+			{
+				error = "invalid object type specifier";
+				break;
+			}
+			SupportedTypes::SupportedTypes type = static_cast<SupportedTypes::SupportedTypes>(block.type);
+			std::uint64_t remaining = block.object_count;
+			do
+			{
+				std::size_t count = (visit == nullptr || remaining < stream_batch_size) ? static_cast<std::size_t>(remaining) : stream_batch_size;
+				std::size_t kept = 0;
+				this->visit_store(type, [&](auto &store)
+				{
+					typedef typename std::decay<decltype(store)>::type::value_type T;
+					if (block.values_per_object != T::coordinate_count)
+					{
+						error = "invalid coordinates for binary geometry block";
+					}
+					else if (!((header.flags & binary_flag_float32) ? read_binary_objects<float>(input, store, count, this->_region, kept)
+					                                                 : read_binary_objects<double>(input, store, count, this->_region, kept)))
+					{
+						error = "truncated binary geometry block";
+					}
+				});
+				if (error == nullptr)
+				{
+					this->append_order(type, kept);
+					this->_filtered += count - kept;
+					remaining -= count;
+				}
+				if (error == nullptr && visit != nullptr)
+				{
+					this->flush_batch(*visit);
+				}
+			} while (error == nullptr && remaining > 0);
+		}
+
+		if (error != nullptr)
+		{
+			std::cerr << "JsonCGAL Error: " << error << std::endl;
+			this->rollback(start);
+			return false;
+		}
+		return true;
+	}
+
+	/**
+	* \brief number of worker threads for a threads option, 0 meaning every
+	*        hardware thread
+	*/
+	static unsigned resolve_threads(unsigned threads)
+	{
+		if (threads == 0)
+		{
+			threads = std::thread::hardware_concurrency();
+		}
+		return (threads == 0) ? 1 : threads;
+	}
+
+	/* smallest slice of a json array worth handing to its own parser thread */
+	static const std::size_t min_parallel_chunk_size = 64 * 1024;
+
+	/**
+	* \brief move every object of another container to the end of this one,
+	*        keeping their order
+	*
+	* \param other, the container to empty into this one
+	*/
+	template <class K>
+	void BasicJsonCGAL<K>::absorb(BasicJsonCGAL &other)
+	{
+		for (std::size_t type = 0; type < supported_type_count; type++)
+		{
+			this->visit_store(static_cast<SupportedTypes::SupportedTypes>(type), [&](auto &store)
+			{
+				typedef typename std::decay<decltype(store)>::type::value_type T;
+				CGAL_list<T> &source = other.store<T>();
+				store.insert(store.end(), std::make_move_iterator(source.begin()), std::make_move_iterator(source.end()));
+				source.clear();
+			});
+		}
+		for (typename CGAL_list<ObjectRun>::iterator run = other._order.begin(); run < other._order.end(); run++)
+		{
+			this->append_order(run->type, run->count);
+		}
+		other._order.clear();
+		other._size = 0;
+	}
+
+	/**
+	* \brief move every object of several containers to the end of this one,
+	*        in container order, reserving the room for them up front
+	*
+	* \param others, the containers to empty into this one
+	*/
+	template <class K>
+	void BasicJsonCGAL<K>::absorb(std::vector<BasicJsonCGAL> &others)
+	{
+		for (std::size_t type = 0; type < supported_type_count; type++)
+		{
+			std::size_t total = this->count(static_cast<SupportedTypes::SupportedTypes>(type));
+			for (std::size_t i = 0; i < others.size(); i++)
+			{
+				total += others[i].count(static_cast<SupportedTypes::SupportedTypes>(type));
+			}
+			this->visit_store(static_cast<SupportedTypes::SupportedTypes>(type), [&](auto &store) { store.reserve(total); });
+		}
+		for (std::size_t i = 0; i < others.size(); i++)
+		{
+			this->absorb(others[i]);
+		}
+	}
+
+	/**
+	* \brief parse a json array held in memory on several threads. The array
+	*        is split into slices of whole elements, each slice is parsed into
+	*        its own container and the results are appended in file order.
+	*
+	* \param data, start of the json text
+	* \param size, number of bytes of json text
+	* \param threads, number of parser threads
+	* \return success/failure
+	*/
+	template <class K>
+	bool BasicJsonCGAL<K>::parse_json_parallel(const char *data, std::size_t size, unsigned threads)
+	{
+		std::vector<ByteRange> chunks;
+		if (!split_json_array(data, size, threads, min_parallel_chunk_size, chunks) || chunks.size() < 2)
+		{
+			/* nothing to split, or malformed text that the serial parser will report */
+			return this->parse_json_buffer(data, size);
+		}
+
+		std::vector<BasicJsonCGAL> results(chunks.size());
+		std::unique_ptr<bool[]> parsed(new bool[chunks.size()]);
+		std::vector<std::thread> workers;
+		for (std::size_t i = 0; i < chunks.size(); i++)
+		{
+			results[i]._region = this->_region;
+			workers.emplace_back([&, i]()
+			{
+				parsed[i] = results[i].parse_json_elements(data + chunks[i].begin, chunks[i].end - chunks[i].begin, false);
+			});
+		}
+		for (std::size_t i = 0; i < workers.size(); i++)
+		{
+			workers[i].join();
+		}
+		for (std::size_t i = 0; i < chunks.size(); i++)
+		{
+			if (!parsed[i])
+			{
+				/* re-parse serially so the error is reported against the whole text */
+				return this->parse_json_stream(nlohmann::detail::input_adapter(data, size));
+			}
+		}
+
+		this->absorb(results);
+		return true;
+	}
+
+	/**
+	* \brief parse geometry held in memory, detecting the format from its
+	*        first bytes
+	*
+	* \param data, start of the buffer
+	* \param size, number of bytes in the buffer
+	* \param options, parser settings
+	* \param source, owner of the buffer for lazy loads, or null if it is not kept
+	* \return success/failure
+	*/
+	template <class K>
+	bool BasicJsonCGAL<K>::parse_buffer(const char *data, std::size_t size, const LoadOptions &options, const std::shared_ptr<const void> &source)
+	{
+		unsigned threads = resolve_threads(options.threads);
+		if (is_tiled_format(data, size))
+		{
+			MemoryStreamBuffer buffer(data, size);
+			std::istream input(&buffer);
+			return this->parse_tiled(input, size, data, options);
+		}
+		Compression::Compression compression = compressed_format(data, size);
+		if (compression != Compression::none)
+		{
+			MemoryStreamBuffer buffer(data, size);
+			return this->parse_compressed(buffer, compression, options);
+		}
+		if (is_binary_format(data, size))
+		{
+			MemoryStreamBuffer buffer(data, size);
+			std::istream input(&buffer);
+			return this->parse_binary_stream(input);
+		}
+		if (is_json_lines(data, size))
+		{
+			std::size_t line_number = 1;
+			return this->parse_json_lines(data, size, line_number, true);
+		}
+		if (options.lazy && source && this->_region == nullptr && this->index_json_buffer(source, data, size))
+		{
+			return true;
+		}
+		if (threads > 1)
+		{
+			return this->parse_json_parallel(data, size, threads);
+		}
+		return this->parse_json_buffer(data, size);
+	}
+
+	/* bytes read from the start of a file to detect its format */
+	static const std::size_t format_sniff_size = 256;
+
+	/* bytes read at a time when a whole stream is read into memory */
+	static const std::size_t stream_read_size = 1 << 20;
+
+	/**
+	* \brief read the rest of a stream into a string
+	*
+	* \param source, the stream to read
+	* \param text, receives the bytes read
+	*/
+	static void read_stream(std::streambuf &source, std::string &text)
+	{
+		std::size_t size = 0;
+		for (;;)
+		{
+			if (text.size() - size < stream_read_size)
+			{
+				text.resize((2 * text.size() > size + stream_read_size) ? 2 * text.size() : size + stream_read_size);
+			}
+			std::streamsize read = source.sgetn(&text[size], static_cast<std::streamsize>(text.size() - size));
+			if (read <= 0)
+			{
+				break;
+			}
+			size += static_cast<std::size_t>(read);
+		}
+		text.resize(size);
+	}
+
+	/**
+	* \brief parse compressed geometry, detecting the format of the
+	*        decompressed data from its first bytes. Binary and json lines
+	*        data is parsed as it is decompressed. Json documents are
+	*        decompressed into memory first so the fast, parallel and lazy
+	*        readers apply. On failure any objects decoded are discarded.
+	*
+	* \param source, the compressed input
+	* \param format, the compression of the input
+	* \param options, parser settings
+	* \return success/failure
+	*/
+	template <class K>
+	bool BasicJsonCGAL<K>::parse_compressed(std::streambuf &source, Compression::Compression format, const LoadOptions &options)
+	{
+		if (!compression_supported(format))
+		{
+			std::cerr << "JsonCGAL Error: " << compression_name(format) << " compressed input is not supported by this build" << std::endl;
+			return false;
+		}
+		Mark start = this->mark();
+		DecompressStreamBuffer decompressed(source, format);
+		std::istream input(&decompressed);
+		const char *head = nullptr;
+		std::size_t length = decompressed.peek(head);
+		bool loaded = false;
+		if (is_binary_format(head, length))
+		{
+			loaded = this->parse_binary_stream(input);
+			/* read to the end so that a damaged trailer is noticed */
+			input.ignore(std::numeric_limits<std::streamsize>::max());
+		}
+		else if (is_json_lines(head, length))
+		{
+			loaded = this->parse_json_lines_stream(input);
+		}
+		else
+		{
+			std::shared_ptr<std::string> text = std::make_shared<std::string>();
+			read_stream(decompressed, *text);
+			loaded = !decompressed.failed() && this->parse_buffer(text->data(), text->size(), options, text);
+		}
+		if (decompressed.failed())
+		{
+			std::cerr << "JsonCGAL Error: corrupt or truncated " << compression_name(format) << " input" << std::endl;
+			this->rollback(start);
+			return false;
+		}
+		return loaded;
+	}
+
+	/**
+		* \brief parse a json geometry file into a json geometry object. By
+		*        default the file is memory mapped and parsed in place, falling
+		*        back to stream input if it cannot be mapped.
+		*
+		* \param filename, the string filename to open
+		* \param options, how the file is read
+		* \return success/failure
+	*/
+	template <class K>
+	bool BasicJsonCGAL<K>::load(std::string filename, const LoadOptions &options)
+	{
+		/* new objects go after every object already loaded */
+		this->decode_all_pending();
+		if (options.memory_map)
+		{
+			std::shared_ptr<MappedFile> mapped = std::make_shared<MappedFile>();
+			if (mapped->open(filename, options.huge_pages))
+			{
+				std::unique_ptr<MappingReadAhead> read_ahead;
+				if (options.read_ahead)
+				{
+					read_ahead = std::make_unique<MappingReadAhead>(mapped->data(), mapped->size());
+				}
+				return this->parse_buffer(mapped->data(), mapped->size(), options, mapped);
+			}
+		}
+
+		std::ifstream infile;
+		char head[format_sniff_size];
+		infile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+		try
+		{
+			infile.open(filename.c_str(), std::ios::in | std::ios::binary);
+
+			/* sniff the format from the first bytes of the file */
+			std::streamsize length = infile.rdbuf()->sgetn(head, sizeof(head));
+			infile.rdbuf()->pubseekpos(0, std::ios::in);
+
+			/* tiled files are read by seeking to their tiles, so they are not read ahead */
+			if (is_tiled_format(head, static_cast<std::size_t>(length)))
+			{
+				std::uint64_t size = static_cast<std::uint64_t>(infile.rdbuf()->pubseekoff(0, std::ios::end, std::ios::in));
+				return this->parse_tiled(infile, size, nullptr, options);
+			}
+
+			/* the parsers read through input, straight from the file or from a reader thread */
+			std::unique_ptr<ReadAheadStreamBuffer> read_ahead;
+			if (options.read_ahead)
+			{
+				read_ahead = std::make_unique<ReadAheadStreamBuffer>(*infile.rdbuf());
+			}
+			std::istream input(options.read_ahead ? static_cast<std::streambuf *>(read_ahead.get()) : infile.rdbuf());
+			Compression::Compression compression = compressed_format(head, static_cast<std::size_t>(length));
+			if (compression != Compression::none)
+			{
+				return this->parse_compressed(*input.rdbuf(), compression, options);
+			}
+			if (is_binary_format(head, static_cast<std::size_t>(length)))
+			{
+				return this->parse_binary_stream(input);
+			}
+			if (is_json_lines(head, static_cast<std::size_t>(length)))
+			{
+				return this->parse_json_lines_stream(input);
+			}
+			if (options.lazy)
+			{
+				std::shared_ptr<std::string> text = std::make_shared<std::string>(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+				return this->parse_buffer(text->data(), text->size(), options, text);
+			}
+			return this->parse_json_stream(nlohmann::detail::input_adapter(input));
+		}
+		catch (const std::ifstream::failure &error)
+		{
+			std::cerr << "JsonCGAL Error: failed to read " << filename << ": " << error.what() << std::endl;
+			return false;
+		}
+	}
+
+	/**
+	* \brief load a file on a separate thread, reading it ahead of the parser.
+	*        The container must not be used until the returned future is ready.
+	*
+	* \param filename, the string filename to open
+	* \param options, how the file is read, read_ahead is always used
+	* \return future holding the success of the load
+	*/
+	template <class K>
+	std::future<bool> BasicJsonCGAL<K>::load_async(std::string filename, const LoadOptions &options)
+	{
+		LoadOptions async_options = options;
+		async_options.read_ahead = true;
+		return std::async(std::launch::async, [this, filename, async_options]() { return this->load(filename, async_options); });
+	}
+
+	/**
+	* \brief load only the objects of a file that reach into a region. Each
+	*        object is tested on its decoded coordinates and dropped before it
+	*        is constructed or stored, so memory use scales with the region
+	*        rather than the file. Bounded objects are kept when their
+	*        bounding box overlaps the region, lines and rays when they cross
+	*        it. Vectors and directions have no position and are dropped.
+	*        Tiled files only read the tiles whose bounds reach into the region.
+	*
+	* \param filename, the string filename to open
+	* \param region, the region to keep, boundary included
+	* \param options, how the file is read. Lazy loading does not apply.
+	* \return success/failure
+	*/
+	template <class K>
+	bool BasicJsonCGAL<K>::load(std::string filename, const typename K::Iso_rectangle_2 &region, const LoadOptions &options)
+	{
+		CGAL::Bbox_2 bounds = region.bbox();
+		RegionScope scope(this->_region, bounds);
+		return this->load(std::move(filename), options);
+	}
+
+	/**
+	 * \brief parse input from a json (or binary geometry) string
+	 * 
+	 * \param json_string 
+	 * \param options, parser settings
+	 * \return true 
+	 * \return false 
+	 */
+	template <class K>
+	bool BasicJsonCGAL<K>::load_from_string(std::string json_string, const LoadOptions &options)
+	{
+		this->decode_all_pending();
+		if (options.lazy)
+		{
+			std::shared_ptr<std::string> text = std::make_shared<std::string>(std::move(json_string));
+			return this->parse_buffer(text->data(), text->size(), options, text);
+		}
+		return this->parse_buffer(json_string.data(), json_string.size(), options, nullptr);
+	}
+
+	/**
+	* \brief parse the objects of a string that reach into a region, see
+	*        load(filename, region, options)
+	*
+	* \param json_string, json or binary geometry
+	* \param region, the region to keep, boundary included
+	* \param options, parser settings. Lazy loading does not apply.
+	* \return success/failure
+	*/
+	template <class K>
+	bool BasicJsonCGAL<K>::load_from_string(std::string json_string, const typename K::Iso_rectangle_2 &region, const LoadOptions &options)
+	{
+		CGAL::Bbox_2 bounds = region.bbox();
+		RegionScope scope(this->_region, bounds);
+		return this->load_from_string(std::move(json_string), options);
+	}
+
+	/**
+	* \brief hand the objects in the container to a visitor and remove them,
+	*        keeping the store memory for the next batch
+	*
+	* \param visit, receives the batch
+	*/
+	template <class K>
+	void BasicJsonCGAL<K>::flush_batch(const BatchVisitor &visit)
+	{
+		visit(*this);
+		Mark empty = {};
+		this->rollback(empty);
+	}
+
+	/**
+	* \brief parse a json geometry document in batches with the general
+	*        parser, handing each batch to a visitor
+	*
+	* \param input, the json input to parse
+	* \param visit, receives each batch of objects
+	* \param skip, number of leading objects that were already handed over
+	* \return success/failure
+	*/
+	template <class K>
+	bool BasicJsonCGAL<K>::stream_json(nlohmann::detail::input_adapter &&input, const BatchVisitor &visit, std::size_t skip)
+	{
+		ObjectStreamSink<K> sink(*this, visit, skip);
+		GeometrySaxHandler handler(sink);
+		if (!nlohmann::json::sax_parse(std::move(input), &handler))
+		{
+			handler.print_error();
+			Mark empty = {};
+			this->rollback(empty);
+			return false;
+		}
+		sink.finish();
+		return true;
+	}
+
+	/**
+	* \brief decode geometry held in memory in batches, handing each batch to
+	*        a visitor. Json documents the fast reader does not accept are
+	*        parsed again by the general parser, which skips the objects that
+	*        were already handed over.
+	*
+	* \param data, start of the buffer
+	* \param size, number of bytes in the buffer
+	* \param visit, receives each batch of objects
+	* \return success/failure
+	*/
+	template <class K>
+	bool BasicJsonCGAL<K>::stream_buffer(const char *data, std::size_t size, const BatchVisitor &visit)
+	{
+		if (is_tiled_format(data, size))
+		{
+			MemoryStreamBuffer buffer(data, size);
+			std::istream input(&buffer);
+			return this->stream_tiled(input, size, data, visit);
+		}
+		Compression::Compression compression = compressed_format(data, size);
+		if (compression != Compression::none)
+		{
+			MemoryStreamBuffer buffer(data, size);
+			return this->stream_compressed(buffer, compression, visit);
+		}
+		bool binary = is_binary_format(data, size);
+		if (binary || is_json_lines(data, size))
+		{
+			MemoryStreamBuffer buffer(data, size);
+			std::istream input(&buffer);
+			return binary ? this->parse_binary_stream(input, &visit) : this->parse_json_lines_stream(input, &visit);
+		}
+
+		ObjectStreamSink<K> sink(*this, visit, 0);
+		GeometrySaxHandler handler(sink);
+		JsonReader reader(data, size);
+		if (reader.parse(handler))
+		{
+			sink.finish();
+			return true;
+		}
+		Mark empty = {};
+		this->rollback(empty);
+		return this->stream_json(nlohmann::detail::input_adapter(data, size), visit, sink.delivered());
+	}
+
+	/**
+	* \brief decode compressed geometry in batches as it is decompressed,
+	*        handing each batch to a visitor
+	*
+	* \param source, the compressed input
+	* \param format, the compression of the input
+	* \param visit, receives each batch of objects
+	* \return success/failure
+	*/
+	template <class K>
+	bool BasicJsonCGAL<K>::stream_compressed(std::streambuf &source, Compression::Compression format, const BatchVisitor &visit)
+	{
+		if (!compression_supported(format))
+		{
+			std::cerr << "JsonCGAL Error: " << compression_name(format) << " compressed input is not supported by this build" << std::endl;
+			return false;
+		}
+		DecompressStreamBuffer decompressed(source, format);
+		std::istream input(&decompressed);
+		const char *head = nullptr;
+		std::size_t length = decompressed.peek(head);
+		bool streamed = false;
+		if (is_binary_format(head, length))
+		{
+			streamed = this->parse_binary_stream(input, &visit);
+			input.ignore(std::numeric_limits<std::streamsize>::max());
+		}
+		else if (is_json_lines(head, length))
+		{
+			streamed = this->parse_json_lines_stream(input, &visit);
+		}
+		else
+		{
+			streamed = this->stream_json(nlohmann::detail::input_adapter(input), visit, 0);
+		}
+		if (decompressed.failed())
+		{
+			std::cerr << "JsonCGAL Error: corrupt or truncated " << compression_name(format) << " input" << std::endl;
+			return false;
+		}
+		return streamed;
+	}
+
+	/**
+	* \brief decode a geometry file in batches, handing each batch to a visitor
+	*        and dropping it. Only one batch, plus a block of text for json
+	*        lines, is held at a time.
+	*
+	* \param filename, the file to read
+	* \param options, how the file is read
+	* \param visit, receives each batch of objects
+	* \return success/failure
+	*/
+	template <class K>
+	bool BasicJsonCGAL<K>::stream_file(const std::string &filename, const LoadOptions &options, const BatchVisitor &visit)
+	{
+		if (options.memory_map)
+		{
+			MappedFile mapped;
+			if (mapped.open(filename, options.huge_pages))
+			{
+				std::unique_ptr<MappingReadAhead> read_ahead;
+				if (options.read_ahead)
+				{
+					read_ahead = std::make_unique<MappingReadAhead>(mapped.data(), mapped.size());
+				}
+				return this->stream_buffer(mapped.data(), mapped.size(), visit);
+			}
+		}
+
+		std::ifstream infile(filename.c_str(), std::ios::in | std::ios::binary);
+		if (!infile.is_open())
+		{
+			std::cerr << "JsonCGAL Error: could not open " << filename << std::endl;
+			return false;
+		}
+		char head[format_sniff_size];
+		std::streamsize length = infile.rdbuf()->sgetn(head, sizeof(head));
+		infile.rdbuf()->pubseekpos(0, std::ios::in);
+		if (is_tiled_format(head, static_cast<std::size_t>(length)))
+		{
+			std::uint64_t size = static_cast<std::uint64_t>(infile.rdbuf()->pubseekoff(0, std::ios::end, std::ios::in));
+			return this->stream_tiled(infile, size, nullptr, visit);
+		}
+		std::unique_ptr<ReadAheadStreamBuffer> read_ahead;
+		if (options.read_ahead)
+		{
+			read_ahead = std::make_unique<ReadAheadStreamBuffer>(*infile.rdbuf());
+		}
+		std::istream input(options.read_ahead ? static_cast<std::streambuf *>(read_ahead.get()) : infile.rdbuf());
+		Compression::Compression compression = compressed_format(head, static_cast<std::size_t>(length));
+		if (compression != Compression::none)
+		{
+			return this->stream_compressed(*input.rdbuf(), compression, visit);
+		}
+		if (is_binary_format(head, static_cast<std::size_t>(length)))
+		{
+			return this->parse_binary_stream(input, &visit);
+		}
+		if (is_json_lines(head, static_cast<std::size_t>(length)))
+		{
+			return this->parse_json_lines_stream(input, &visit);
+		}
+		return this->stream_json(nlohmann::detail::input_adapter(input), visit, 0);
+	}
+
+	/**
+	* \brief make sure lines appended to a json lines file start on a line of
+	*        their own. An unterminated last line that holds one geometry
+	*        object is ended with a newline. One that does not parse, left by
+	*        an interrupted writer, is cut off.
+	*
+	* \param filename, the file to check
+	*/
+	template <class K>
+	void BasicJsonCGAL<K>::terminate_last_line(const std::string &filename)
+	{
+		std::error_code error;
+		std::uintmax_t size = std::filesystem::file_size(filename, error);
+		if (error || size == 0)
+		{
+			return;
+		}
+
+		std::ifstream infile(filename.c_str(), std::ios::in | std::ios::binary);
+		char block[4096];
+		std::uintmax_t end = size;
+		bool found = false;
+		while (end > 0 && !found)
+		{
+			std::size_t count = (end < sizeof(block)) ? static_cast<std::size_t>(end) : sizeof(block);
+			infile.seekg(static_cast<std::streamoff>(end - count));
+			if (!infile.read(block, static_cast<std::streamsize>(count)))
+			{
+				return;
+			}
+			const char *newline = std::find(std::make_reverse_iterator(block + count), std::make_reverse_iterator(block), '\n').base();
+			found = (newline != block);
+			end -= count - static_cast<std::size_t>(newline - block);
+		}
+		if (end == size)
+		{
+			return;
+		}
+
+		/* the last line is parsed the same way parse_json_lines checks a single line */
+		std::string tail(static_cast<std::size_t>(size - end), '\0');
+		infile.clear();
+		infile.seekg(static_cast<std::streamoff>(end));
+		if (!infile.read(&tail[0], static_cast<std::streamsize>(tail.size())))
+		{
+			return;
+		}
+		infile.close();
+		if (skip_json_whitespace(tail.data(), tail.data() + tail.size()) != tail.data() + tail.size())
+		{
+			BasicJsonCGAL line;
+			if (line.parse_json_elements(tail.data(), tail.size(), false) && line._size == 1)
+			{
+				std::ofstream(filename.c_str(), std::ios::out | std::ios::app | std::ios::binary) << '\n';
+				return;
+			}
+			std::cerr << "JsonCGAL Warning: removing incomplete last line of " << filename << std::endl;
+		}
+		std::filesystem::resize_file(filename, end, error);
+	}
+
+	/**
+		* \brief dump a json geometry object into a file
+		*
+		* \param filename, the string filename/path to record to
+		* \param options, the file format and layout to write
+		* \return success/failure
+	*/
+	template <class K>
+	bool BasicJsonCGAL<K>::dump(std::string filename, const DumpOptions &options)
+	{
+		std::string buffer;
+		this->decode_all_pending();
+		if (!compression_supported(options.compression))
+		{
+			std::cerr << "JsonCGAL Error: " << compression_name(options.compression) << " compression is not supported by this build" << std::endl;
+			return false;
+		}
+		if (options.append)
+		{
+			if (options.format != FileFormat::json_lines || options.compression != Compression::none)
+			{
+				std::cerr << "JsonCGAL Error: only uncompressed json lines files can be appended to" << std::endl;
+				return false;
+			}
+			terminate_last_line(filename);
+		}
+		std::ofstream outfile;
+		outfile.exceptions(std::ofstream::failbit | std::ofstream::badbit);
+		try
+		{
+			outfile.open(filename.c_str(), std::ios::out | std::ios::binary | (options.append ? std::ios::app : std::ios::trunc));
+
+			/* compressed output goes through a compressing buffer in front of the file */
+			std::unique_ptr<CompressStreamBuffer> compressed;
+			if (options.compression != Compression::none && options.format != FileFormat::tiled)
+			{
+				compressed = std::make_unique<CompressStreamBuffer>(*outfile.rdbuf(), options.compression, options.compression_level, resolve_threads(options.threads));
+			}
+			std::ostream compressed_output(compressed.get());
+			std::ostream &output = compressed ? compressed_output : outfile;
+
+			if (options.format == FileFormat::binary)
+			{
+				this->write_binary_stream(output);
+			}
+			else if (options.format == FileFormat::tiled)
+			{
+				if (!this->write_tiled_stream(output, options))
+				{
+					return false;
+				}
+			}
+			else
+			{
+				this->write_json(buffer, options, resolve_threads(options.threads), &output);
+				if (options.format != FileFormat::json_lines)
+				{
+					buffer.push_back('\n');
+				}
+				output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+			}
+			if (compressed && (!compressed_output || !compressed->finish()))
+			{
+				std::cerr << "JsonCGAL Error: failed to write compressed output to " << filename << std::endl;
+				return false;
+			}
+		}
+		catch (const std::ofstream::failure &error)
+		{
+			std::cerr << "JsonCGAL Error: failed to write " << filename << ": " << error.what() << std::endl;
+			return false;
+		}
+		return true;
+	}
+
+	template <class K>
+	bool BasicJsonCGAL<K>::dump(std::string filename, FileFormat::FileFormat format)
+	{
+		DumpOptions options;
+		options.format = format;
+		return this->dump(filename, options);
+	}
+
+	/**
+	* \brief dump a json geometry object to a string
+	*
+	* \param options, the format and layout to encode the objects in
+	* \return the encoded objects
+	*/
+	template <class K>
+	std::string BasicJsonCGAL<K>::dump_to_string(const DumpOptions &options)
+	{
+		std::string output;
+		this->decode_all_pending();
+		if (!compression_supported(options.compression))
+		{
+			std::cerr << "JsonCGAL Error: " << compression_name(options.compression) << " compression is not supported by this build" << std::endl;
+			return output;
+		}
+		if (options.compression != Compression::none && options.format != FileFormat::tiled)
+		{
+			DumpOptions uncompressed = options;
+			uncompressed.compression = Compression::none;
+			std::string text = this->dump_to_string(uncompressed);
+			std::ostringstream stream(std::ios::out | std::ios::binary);
+			CompressStreamBuffer compressed(*stream.rdbuf(), options.compression, options.compression_level, resolve_threads(options.threads));
+			compressed.sputn(text.data(), static_cast<std::streamsize>(text.size()));
+			if (!compressed.finish())
+			{
+				std::cerr << "JsonCGAL Error: failed to write compressed output" << std::endl;
+				return std::string();
+			}
+			return stream.str();
+		}
+		if (options.format == FileFormat::binary)
+		{
+			std::ostringstream stream(std::ios::out | std::ios::binary);
+			this->write_binary_stream(stream);
+			return stream.str();
+		}
+		if (options.format == FileFormat::tiled)
+		{
+			std::ostringstream stream(std::ios::out | std::ios::binary);
+			if (!this->write_tiled_stream(stream, options))
+			{
+				return std::string();
+			}
+			return stream.str();
+		}
+		this->write_json(output, options, resolve_threads(options.threads), nullptr);
+		return output;
+	}
+
+	template <class K>
+	std::string BasicJsonCGAL<K>::dump_to_string(FileFormat::FileFormat format)
+	{
+		DumpOptions options;
+		options.format = format;
+		return this->dump_to_string(options);
+	}
+
+	/* spatial index ids hold the object type in their low bits and the store index above it */
+	static const unsigned spatial_type_bits = 4;
+	static_assert(supported_type_count <= (1u << spatial_type_bits), "every object type needs a spatial index id");
+
+	/**
+	* \brief exact intersection test between a stored object and a box
+	*/
+	template <class T, class Rectangle>
+	static bool intersects_box(const T &object, const Rectangle &box)
+	{
+		if constexpr (T::type_tag == SupportedTypes::vector_2 || T::type_tag == SupportedTypes::direction_2)
+		{
+			return false;
+		}
+		else if constexpr (T::type_tag == SupportedTypes::weighted_point_2)
+		{
+			return CGAL::do_intersect(object.point(), box);
+		}
+		else
+		{
+			return CGAL::do_intersect(static_cast<const typename T::kernel_type &>(object), box);
+		}
+	}
+
+	/**
+	* \brief build the spatial index used by query, if it is not built yet.
+	*        The index is packed in one pass over every stored object, and is
+	*        dropped whenever objects are added or removed. Lazily loaded
+	*        types are decoded first.
+	*/
+	template <class K>
+	void BasicJsonCGAL<K>::build_index() const
+	{
+		this->spatial_index();
+	}
+
+	/**
+	* \brief the spatial index, built on the first call. The index is published
+	*        with an atomic compare and swap, so const queries from several
+	*        threads are safe: threads racing to build it each pack an index
+	*        and all of them use the first one stored.
+	*
+	* \return the spatial index, kept alive by the caller while it is used
+	*/
+	template <class K>
+	std::shared_ptr<const typename BasicJsonCGAL<K>::SpatialObjects> BasicJsonCGAL<K>::spatial_index() const
+	{
+		std::shared_ptr<const SpatialObjects> spatial = std::atomic_load(&this->_spatial);
+		if (spatial)
+		{
+			return spatial;
+		}
+		this->decode_all_pending();
+		std::vector<SpatialIndex::Entry> entries;
+		std::vector<ObjectRef> unbounded;
+		entries.reserve(this->_size);
+		for (std::size_t type = 0; type < supported_type_count; type++)
+		{
+			this->visit_store(static_cast<SupportedTypes::SupportedTypes>(type), [&](const auto &store)
+			{
+				typedef typename std::decay<decltype(store)>::type::value_type T;
+				if constexpr (T::type_tag == SupportedTypes::vector_2 || T::type_tag == SupportedTypes::direction_2)
+				{
+					/* no position, never part of a query result */
+				}
+				else if constexpr (T::type_tag == SupportedTypes::line_2 || T::type_tag == SupportedTypes::ray_2)
+				{
+					for (std::size_t i = 0; i < store.size(); i++)
+					{
+						unbounded.push_back(ObjectRef{T::type_tag, i});
+					}
+				}
+				else
+				{
+					for (std::size_t i = 0; i < store.size(); i++)
+					{
+						CGAL::Bbox_2 bounds = store[i].bbox();
+						std::uint64_t id = (static_cast<std::uint64_t>(i) << spatial_type_bits) | T::type_tag;
+						entries.push_back(SpatialIndex::Entry{index_box(bounds.xmin(), bounds.ymin(), bounds.xmax(), bounds.ymax()), id});
+					}
+				}
+			});
+		}
+		std::shared_ptr<const SpatialObjects> built = std::make_shared<const SpatialObjects>(SpatialObjects{SpatialIndex(std::move(entries)), std::move(unbounded)});
+		if (!std::atomic_compare_exchange_strong(&this->_spatial, &spatial, built))
+		{
+			/* another thread stored its index first, spatial now holds it */
+			return spatial;
+		}
+		return built;
+	}
+
+	/**
+	* \brief find the stored objects that intersect a box, using the spatial
+	*        index instead of a scan over every object. Candidates found by
+	*        their bounding boxes are checked with an exact intersection test.
+	*        Vectors and directions have no position and are never returned.
+	*
+	* \param box, the region to search, boundary included
+	* \return the objects found, ordered by type and then by store index
+	*/
+	template <class K>
+	std::vector<ObjectRef> BasicJsonCGAL<K>::query(const typename K::Iso_rectangle_2 &box) const
+	{
+		std::shared_ptr<const SpatialObjects> index = this->spatial_index();
+		const SpatialObjects &spatial = *index;
+		CGAL::Bbox_2 bounds = box.bbox();
+		std::vector<std::uint64_t> ids;
+		spatial.index.query(index_box(bounds.xmin(), bounds.ymin(), bounds.xmax(), bounds.ymax()), ids);
+
+		std::vector<ObjectRef> found;
+		auto test = [&](const ObjectRef &object)
+		{
+			this->visit_store(object.type, [&](const auto &store)
+			{
+				if (intersects_box(store[object.index], box))
+				{
+					found.push_back(object);
+				}
+			});
+		};
+		for (std::uint64_t id : ids)
+		{
+			test(ObjectRef{static_cast<SupportedTypes::SupportedTypes>(id & ((1u << spatial_type_bits) - 1)), static_cast<std::size_t>(id >> spatial_type_bits)});
+		}
+		for (const ObjectRef &object : spatial.unbounded)
+		{
+			test(object);
+		}
+		std::sort(found.begin(), found.end(), [](const ObjectRef &a, const ObjectRef &b)
+		{
+			return (a.type != b.type) ? a.type < b.type : a.index < b.index;
+		});
+		return found;
+	}
+
+	/**
+	* \brief write all objects in the tiled geometry format. Bounded objects
+	*        go in the quadtree tile holding the centre of their bounding box,
+	*        and each tile is written as a binary geometry stream with one
+	*        block per type, in store order within the type.
+	*
+	* \param output, stream to write to
+	* \param options, tile size and the compression of each tile
+	* \return false if a tile failed to compress
+	*/
+	template <class K>
+	bool BasicJsonCGAL<K>::write_tiled_stream(std::ostream &output, const DumpOptions &options)
+	{
+		const std::uint64_t type_mask = (1u << spatial_type_bits) - 1;
+		std::vector<TileItem> items;
+		std::vector<TileItem> unbounded;
+		items.reserve(this->_size);
+		for (std::size_t type = 0; type < supported_type_count; type++)
+		{
+			this->visit_store(static_cast<SupportedTypes::SupportedTypes>(type), [&](const auto &store)
+			{
+				typedef typename std::decay<decltype(store)>::type::value_type T;
+				double values[T::coordinate_count];
+				double box[4];
+				for (std::size_t i = 0; i < store.size(); i++)
+				{
+					std::uint64_t id = (static_cast<std::uint64_t>(i) << spatial_type_bits) | T::type_tag;
+					store[i].flatten(values);
+					if (flat_box(T::type_tag, values, box))
+					{
+						items.push_back(TileItem{box[0] + (box[2] - box[0]) / 2, box[1] + (box[3] - box[1]) / 2, id});
+					}
+					else
+					{
+						unbounded.push_back(TileItem{0.0, 0.0, id});
+					}
+				}
+			});
+		}
+		std::vector<std::size_t> ends;
+		quadtree_tiles(items, options.tile_objects, ends);
+		std::size_t bounded = items.size();
+		if (!unbounded.empty())
+		{
+			items.insert(items.end(), unbounded.begin(), unbounded.end());
+			ends.push_back(items.size());
+		}
+
+		const double infinity = std::numeric_limits<double>::infinity();
+		std::uint16_t flags = std::is_same<number_type, float>::value ? binary_flag_float32 : 0;
+		std::vector<TileEntry> tiles;
+		std::vector<std::size_t> indices;
+		std::uint64_t offset = tiled_header_size;
+		std::size_t first = 0;
+		write_tiled_header(output);
+		for (std::size_t end : ends)
+		{
+			/* ids of one type differ only in their store index, so this groups by type in store order */
+			std::sort(items.begin() + first, items.begin() + end, [type_mask](const TileItem &a, const TileItem &b)
+			{
+				return ((a.id & type_mask) != (b.id & type_mask)) ? (a.id & type_mask) < (b.id & type_mask) : a.id < b.id;
+			});
+			std::uint64_t blocks = 0;
+			for (std::size_t i = first; i < end; i++)
+			{
+				blocks += (i == first || (items[i].id & type_mask) != (items[i - 1].id & type_mask)) ? 1 : 0;
+			}
+
+			TileEntry tile = (first < bounded) ? TileEntry{infinity, infinity, -infinity, -infinity, offset, 0, end - first}
+			                                   : TileEntry{-infinity, -infinity, infinity, infinity, offset, 0, end - first};
+			std::ostringstream stream(std::ios::out | std::ios::binary);
+			BinaryHeader header = {binary_version, flags, blocks};
+			write_binary_header(stream, header);
+			for (std::size_t run = first; run < end;)
+			{
+				SupportedTypes::SupportedTypes type = static_cast<SupportedTypes::SupportedTypes>(items[run].id & type_mask);
+				indices.clear();
+				for (; run < end && (items[run].id & type_mask) == type; run++)
+				{
+					indices.push_back(static_cast<std::size_t>(items[run].id >> spatial_type_bits));
+				}
+				this->visit_store(type, [&](const auto &store)
+				{
+					typedef typename std::decay<decltype(store)>::type::value_type T;
+					BinaryBlockHeader block = {static_cast<std::uint8_t>(type), T::coordinate_count, indices.size()};
+					write_binary_block_header(stream, block);
+					write_binary_objects<number_type>(stream, store, 0, indices.size(), indices.data());
+					double values[T::coordinate_count];
+					double box[4];
+					for (std::size_t index : indices)
+					{
+						store[index].flatten(values);
+						if (flat_box(T::type_tag, values, box))
+						{
+							tile.xmin = std::min(tile.xmin, box[0]);
+							tile.ymin = std::min(tile.ymin, box[1]);
+							tile.xmax = std::max(tile.xmax, box[2]);
+							tile.ymax = std::max(tile.ymax, box[3]);
+						}
+					}
+				});
+			}
+
+			std::string bytes = stream.str();
+			if (options.compression != Compression::none)
+			{
+				std::ostringstream packed(std::ios::out | std::ios::binary);
+				CompressStreamBuffer compressed(*packed.rdbuf(), options.compression, options.compression_level, resolve_threads(options.threads));
+				compressed.sputn(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+				if (!compressed.finish())
+				{
+					std::cerr << "JsonCGAL Error: failed to write compressed output" << std::endl;
+					return false;
+				}
+				bytes = packed.str();
+			}
+			output.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+			tile.size = bytes.size();
+			tiles.push_back(tile);
+			offset += tile.size;
+			first = end;
+		}
+		write_tile_index(output, tiles, offset);
+		return true;
+	}
+
+	/**
+	* \brief check that a tile of a tiled file holds a binary geometry stream,
+	*        either plain or compressed
+	*/
+	static bool valid_tile(const char *data, std::size_t size)
+	{
+		if (is_binary_format(data, size) || compressed_format(data, size) != Compression::none)
+		{
+			return true;
+		}
+		std::cerr << "JsonCGAL Error: invalid tile in tiled geometry file" << std::endl;
+		return false;
+	}
+
+	/**
+	* \brief read the bytes of one tile from a tiled file
+	*
+	* \param input, seekable stream over the whole file
+	* \param tile, the tile to read
+	* \param bytes, receives tile.size bytes
+	* \return false if the file ended early
+	*/
+	static bool read_tile(std::istream &input, const TileEntry &tile, char *bytes)
+	{
+		if (input.seekg(static_cast<std::streamoff>(tile.offset)) && input.read(bytes, static_cast<std::streamsize>(tile.size)))
+		{
+			return true;
+		}
+		std::cerr << "JsonCGAL Error: truncated tiled geometry file" << std::endl;
+		return false;
+	}
+
+	/**
+	* \brief read a tiled geometry file. Only the tiles whose bounds reach into
+	*        the load region are read, or every tile without a region, and
+	*        the objects in them are then filtered like any region load.
+	*
+	* \param input, seekable stream over the whole file
+	* \param size, size of the file in bytes
+	* \param data, the file held in memory, or null to read the tiles from input
+	* \param options, parser settings, tiles are decoded on options.threads workers
+	* \return success/failure
+	*/
+	template <class K>
+	bool BasicJsonCGAL<K>::parse_tiled(std::istream &input, std::uint64_t size, const char *data, const LoadOptions &options)
+	{
+		std::vector<TileEntry> tiles;
+		if (!read_tile_index(input, size, tiles))
+		{
+			std::cerr << "JsonCGAL Error: invalid tiled geometry index" << std::endl;
+			return false;
+		}
+		std::string read;
+		std::vector<ByteRange> selected;
+		for (const TileEntry &tile : tiles)
+		{
+			if (this->_region != nullptr && !box_in_region(tile.xmin, tile.ymin, tile.xmax, tile.ymax, *this->_region))
+			{
+				continue;
+			}
+			if (data != nullptr)
+			{
+				selected.push_back(ByteRange{static_cast<std::size_t>(tile.offset), static_cast<std::size_t>(tile.offset + tile.size)});
+				continue;
+			}
+			std::size_t start = read.size();
+			read.resize(start + static_cast<std::size_t>(tile.size));
+			if (!read_tile(input, tile, &read[start]))
+			{
+				return false;
+			}
+			selected.push_back(ByteRange{start, read.size()});
+		}
+		return this->parse_tiles((data != nullptr) ? data : read.data(), selected, resolve_threads(options.threads));
+	}
+
+	/**
+	* \brief decode tiles held in memory and append their objects in tile
+	*        order. With several threads each tile is decoded into a container
+	*        of its own, and the containers are appended once all succeed.
+	*        On failure no objects are added.
+	*
+	* \param data, the buffer holding the tiles
+	* \param tiles, the byte range of each tile in data
+	* \param threads, number of decoding threads
+	* \return success/failure
+	*/
+	template <class K>
+	bool BasicJsonCGAL<K>::parse_tiles(const char *data, const std::vector<ByteRange> &tiles, unsigned threads)
+	{
+		auto parse_tile = [data](BasicJsonCGAL &container, const ByteRange &tile)
+		{
+			return valid_tile(data + tile.begin, tile.end - tile.begin) && container.parse_buffer(data + tile.begin, tile.end - tile.begin, LoadOptions(), nullptr);
+		};
+		if (threads < 2 || tiles.size() < 2)
+		{
+			Mark start = this->mark();
+			for (const ByteRange &tile : tiles)
+			{
+				if (!parse_tile(*this, tile))
+				{
+					this->rollback(start);
+					return false;
+				}
+			}
+			return true;
+		}
+
+		std::vector<BasicJsonCGAL> results(tiles.size());
+		std::unique_ptr<bool[]> parsed(new bool[tiles.size()]);
+		std::atomic<std::size_t> next(0);
+		std::vector<std::thread> workers;
+		for (unsigned t = 0; t < threads && t < tiles.size(); t++)
+		{
+			workers.emplace_back([&]()
+			{
+				for (std::size_t i = next++; i < tiles.size(); i = next++)
+				{
+					results[i]._region = this->_region;
+					parsed[i] = parse_tile(results[i], tiles[i]);
+				}
+			});
+		}
+		for (std::size_t i = 0; i < workers.size(); i++)
+		{
+			workers[i].join();
+		}
+		for (std::size_t i = 0; i < tiles.size(); i++)
+		{
+			if (!parsed[i])
+			{
+				return false;
+			}
+		}
+		this->absorb(results);
+		return true;
+	}
+
+	/**
+	* \brief decode every tile of a tiled file in file order, in batches
+	*        handed to a visitor. Tiles read from a stream are read one at a time.
+	*
+	* \param input, seekable stream over the whole file
+	* \param size, size of the file in bytes
+	* \param data, the file held in memory, or null to read the tiles from input
+	* \param visit, receives each batch of objects
+	* \return success/failure
+	*/
+	template <class K>
+	bool BasicJsonCGAL<K>::stream_tiled(std::istream &input, std::uint64_t size, const char *data, const BatchVisitor &visit)
+	{
+		std::vector<TileEntry> tiles;
+		if (!read_tile_index(input, size, tiles))
+		{
+			std::cerr << "JsonCGAL Error: invalid tiled geometry index" << std::endl;
+			return false;
+		}
+		std::string read;
+		for (const TileEntry &tile : tiles)
+		{
+			const char *bytes = (data != nullptr) ? data + tile.offset : nullptr;
+			if (data == nullptr)
+			{
+				read.resize(static_cast<std::size_t>(tile.size));
+				if (!read_tile(input, tile, &read[0]))
+				{
+					return false;
+				}
+				bytes = read.data();
+			}
+			if (!valid_tile(bytes, static_cast<std::size_t>(tile.size)) || !this->stream_buffer(bytes, static_cast<std::size_t>(tile.size), visit))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/* containers for the kernels listed in cgal_kernel_config.h */
+#define JSON_CGAL_INSTANTIATE_CONTAINER(K) template class BasicJsonCGAL<K>;
+	JSON_CGAL_FOR_EACH_KERNEL(JSON_CGAL_INSTANTIATE_CONTAINER)
+#undef JSON_CGAL_INSTANTIATE_CONTAINER
 };
@@ -17,10 +17,26 @@
 /* ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ includes ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~*/
 #include <string>
 #include <fstream>
+#include <istream>
+#include <ostream>
 #include <vector>
+#include <tuple>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <memory>
+#include <functional>
+#include <future>
 
 #include "json.hpp"
 #include "JsonCGALMap.h"
+#include "JsonCGALSax.h"
+#include "JsonCGALWriter.h"
+#include "JsonCGALCompression.h"
+#include "JsonCGALScanner.h"
+#include "JsonCGALSpatialIndex.h"
 #include "JsonCGALTypes.h"
 #include "cgal_kernel_config.h"
 
@@ -28,55 +44,515 @@
 
 namespace JsonCGAL
 {	
-   /* main object container class */
-   class JsonCGAL
+   /* file formats understood by load and dump */
+   namespace FileFormat
    {
+      enum FileFormat
+      {
+         json,
+         binary,
+         /* one json value per line, always written in the compact schema */
+         json_lines,
+         /* binary geometry split into quadtree tiles, with an index of tile bounds at
+            the end so a load with a region reads only the tiles reaching into it.
+            Objects are grouped by tile and then type, so their order is not kept */
+         tiled,
+      };
+   };
+
+   /* json layouts written by dump, load accepts either. Json lines ignore the
+      schema and are always written compact */
+   namespace JsonSchema
+   {
+      enum JsonSchema
+      {
+         /* objects with "type" and "coordinates" keys, e.g. {"type": "point_2", "coordinates": [1.0, 2.0]}.
+            Only points, segments and lines have this encoding, other types are written compact */
+         nested,
+         /* a type key and the flat coordinate layout of the object, e.g. ["point_2", [1.0, 2.0]] */
+         compact,
+         /* one block of coordinate columns per type, e.g. {"point_2": {"x": [1.0, 3.0], "y": [2.0, 4.0]}}.
+            Objects are grouped by type, so the order between types is not kept */
+         columnar,
+      };
+   };
+
+   /* options controlling how load reads a file */
+   struct LoadOptions
+   {
+      /* parse straight from a read only memory mapping of the file */
+      bool memory_map = true;
+      /* ask for transparent huge pages on the mapping (linux only) */
+      bool huge_pages = false;
+      /* worker threads used to parse json arrays held in memory and the tiles of a tiled
+         file, 0 uses every hardware thread */
+      unsigned threads = 1;
+      /* only index json objects by type while loading, and decode each type on
+         its first access. Columnar, json lines and binary files, and loads with a
+         region, are always decoded on load. Load only checks the structure of the
+         array, a type whose objects fail to decode is dropped on first access;
+         decode_all() decodes every type at once and reports the failure. Const
+         accessors decode, so a lazily loaded container must not be read from
+         several threads until decode_all() has been called */
+      bool lazy = false;
+      /* read the file on a separate thread ahead of the parser, so reads overlap with decoding */
+      bool read_ahead = false;
+   };
+
+   /* options controlling how dump writes objects */
+   struct DumpOptions
+   {
+      FileFormat::FileFormat format = FileFormat::json;
+      JsonSchema::JsonSchema schema = JsonSchema::nested;
+      /* spaces per indent level for json output, negative for compact single line output */
+      int indent = 4;
+      /* worker threads used to encode json, 0 uses every hardware thread */
+      unsigned threads = 1;
+      /* add the objects to the end of an existing json lines file instead of replacing it */
+      bool append = false;
+      /* compression of the written file or string, blocks are compressed on threads workers.
+         Tiled files compress each tile on its own. load detects compressed input by itself */
+      Compression::Compression compression = Compression::none;
+      /* compression level, 0 uses the library default */
+      int compression_level = 0;
+      /* most objects in a tile of a tiled file, fuller quadtree cells are split in four */
+      std::size_t tile_objects = 65536;
+   };
+
+   /* per-type contiguous object stores of kernel K, ordered to match SupportedTypes */
+   template <class K>
+   using BasicObjectStores = std::tuple<CGAL_list<Basic_point_2<K>>, CGAL_list<Basic_line_2<K>>, CGAL_list<Basic_segment_2<K>>,
+                                        CGAL_list<Basic_weighted_point_2<K>>, CGAL_list<Basic_vector_2<K>>, CGAL_list<Basic_direction_2<K>>,
+                                        CGAL_list<Basic_ray_2<K>>, CGAL_list<Basic_triangle_2<K>>, CGAL_list<Basic_iso_rectangle_2<K>>,
+                                        CGAL_list<Basic_circle_2<K>>>;
+
+   typedef BasicObjectStores<Kernel> ObjectStores;
+
+   /* number of supported object types */
+   static const std::size_t supported_type_count = std::tuple_size<ObjectStores>::value;
+
+   /* index of the store (and SupportedTypes value) holding objects of type T */
+   template <class T, class Stores>
+   struct store_index;
+
+   template <class T, class... Lists>
+   struct store_index<T, std::tuple<CGAL_list<T>, Lists...>>
+   {
+      static const std::size_t value = 0;
+   };
+
+   template <class T, class U, class... Lists>
+   struct store_index<T, std::tuple<CGAL_list<U>, Lists...>>
+   {
+      static const std::size_t value = 1 + store_index<T, std::tuple<Lists...>>::value;
+   };
+
+   /**
+    * \brief non-owning read only range over the stored objects of one type.
+    *        The view is invalidated by any call that adds objects of that type.
+    */
+   template <class T>
+   class ObjectView
+   {
+   public:
+      typedef T value_type;
+      typedef const T &reference;
+      typedef typename CGAL_list<T>::const_iterator iterator;
+      typedef typename CGAL_list<T>::const_iterator const_iterator;
+
+      ObjectView(const_iterator first, const_iterator last) : _first(first), _last(last) {}
+
+      const_iterator begin() const { return this->_first; }
+      const_iterator end() const { return this->_last; }
+      std::size_t size() const { return static_cast<std::size_t>(this->_last - this->_first); }
+      bool empty() const { return this->_first == this->_last; }
+      const T &operator[](std::size_t index) const { return this->_first[index]; }
+      const T &front() const { return *this->_first; }
+      const T &back() const { return *(this->_last - 1); }
+
    private:
-	   void parse_json_container(nlohmann::json container);
-	   nlohmann::json create_json_container();
-	   CGAL_list<JsonCGALBase *> _objs;
+      const_iterator _first;
+      const_iterator _last;
+   };
+
+   /**
+    * \brief make room for extra more objects in a store, growing its capacity
+    *        geometrically so repeated small appends stay amortized O(1)
+    */
+   template <class T>
+   void reserve_additional(CGAL_list<T> &store, std::size_t extra)
+   {
+      std::size_t needed = store.size() + extra;
+      if (needed > store.capacity())
+      {
+         store.reserve((needed > 2 * store.capacity()) ? needed : 2 * store.capacity());
+      }
+   }
+
+   /* position of a stored object, it is view<T>()[index] for the wrapper T of type */
+   struct ObjectRef
+   {
+      SupportedTypes::SupportedTypes type;
+      std::size_t index;
+   };
 
+   template <class K>
+   class ObjectStoreSink;
+   template <class K>
+   class ObjectStreamSink;
+
+   /**
+    * \brief main object container class, storing objects of kernel K. The
+    *        wrappers derive from the kernel's own types, so objects move
+    *        between the container and algorithms on K without a conversion.
+    *        Instantiated for the kernels in JSON_CGAL_FOR_EACH_KERNEL.
+    */
+   template <class K>
+   class BasicJsonCGAL
+   {
    public:
-	   bool load(std::string filename);
-	   bool load_from_string(std::string json_string);
-	   bool dump(std::string filename);
-	   std::string dump_to_string();
-      ~JsonCGAL()
+      typedef K kernel_type;
+      typedef typename coordinate_number<K>::type number_type;
+      typedef Basic_point_2<K> Point_2d;
+      typedef Basic_line_2<K> Line_2d;
+      typedef Basic_segment_2<K> Segment_2d;
+      typedef Basic_weighted_point_2<K> Weighted_point_2d;
+      typedef Basic_vector_2<K> Vector_2d;
+      typedef Basic_direction_2<K> Direction_2d;
+      typedef Basic_ray_2<K> Ray_2d;
+      typedef Basic_triangle_2<K> Triangle_2d;
+      typedef Basic_iso_rectangle_2<K> Iso_rectangle_2d;
+      typedef Basic_circle_2<K> Circle_2d;
+      typedef BasicObjectStores<K> ObjectStores;
+
+   private:
+      friend class ObjectStoreSink<K>;
+      friend class ObjectStreamSink<K>;
+
+      /* run of consecutively inserted objects of one type, keeps the global insertion order */
+      struct ObjectRun
+      {
+         SupportedTypes::SupportedTypes type;
+         std::size_t count;
+      };
+
+      /* container sizes used to roll back a failed load */
+      struct Mark
+      {
+         /* decoded objects in each store, lazily loaded objects are counted apart */
+         std::size_t sizes[supported_type_count];
+         std::size_t pending[supported_type_count];
+         std::size_t pending_runs[supported_type_count];
+         std::size_t runs;
+         std::size_t last_run_count;
+         std::size_t filtered;
+      };
+
+      /* json text of a lazily loaded type that has not been decoded yet */
+      struct PendingObjects
       {
-         for (CGAL_list<JsonCGALBase*>::iterator it = this->_objs.begin(); it < this->_objs.end(); it++)
+         /* keeps the text alive, a mapped file or a copy of the loaded string */
+         std::shared_ptr<const void> source;
+         const char *text = nullptr;
+         /* runs of consecutive array elements of the type */
+         std::vector<ByteRange> runs;
+         std::size_t count = 0;
+      };
+
+      /* spatial index over the objects with a bounded extent, and the unbounded
+         lines and rays that every query tests */
+      struct SpatialObjects
+      {
+         SpatialIndex index;
+         std::vector<ObjectRef> unbounded;
+      };
+
+      /* receives each batch of objects decoded while streaming a file */
+      typedef std::function<void(const BasicJsonCGAL &)> BatchVisitor;
+
+      bool parse_json_stream(nlohmann::detail::input_adapter &&input);
+      bool parse_json_buffer(const char *data, std::size_t size);
+      bool parse_json_elements(const char *data, std::size_t size, bool report_errors);
+      bool parse_json_lines(const char *data, std::size_t size, std::size_t &line_number, bool final);
+      bool parse_json_lines_stream(std::istream &input, const BatchVisitor *visit = nullptr);
+      static void terminate_last_line(const std::string &filename);
+      bool parse_binary_stream(std::istream &input, const BatchVisitor *visit = nullptr);
+      bool parse_buffer(const char *data, std::size_t size, const LoadOptions &options, const std::shared_ptr<const void> &source);
+      bool parse_compressed(std::streambuf &source, Compression::Compression format, const LoadOptions &options);
+      bool parse_tiled(std::istream &input, std::uint64_t size, const char *data, const LoadOptions &options);
+      bool parse_tiles(const char *data, const std::vector<ByteRange> &tiles, unsigned threads);
+      bool stream_file(const std::string &filename, const LoadOptions &options, const BatchVisitor &visit);
+      bool stream_buffer(const char *data, std::size_t size, const BatchVisitor &visit);
+      bool stream_compressed(std::streambuf &source, Compression::Compression format, const BatchVisitor &visit);
+      bool stream_json(nlohmann::detail::input_adapter &&input, const BatchVisitor &visit, std::size_t skip);
+      bool stream_tiled(std::istream &input, std::uint64_t size, const char *data, const BatchVisitor &visit);
+      void flush_batch(const BatchVisitor &visit);
+      bool index_json_buffer(const std::shared_ptr<const void> &source, const char *data, std::size_t size);
+      bool decode_pending(SupportedTypes::SupportedTypes type) const;
+      bool decode_all_pending() const;
+      std::shared_ptr<const SpatialObjects> spatial_index() const;
+      void drop_last_objects(SupportedTypes::SupportedTypes type, std::size_t count) const;
+      bool parse_json_parallel(const char *data, std::size_t size, unsigned threads);
+      void absorb(BasicJsonCGAL &other);
+      void absorb(std::vector<BasicJsonCGAL> &others);
+      void write_json(std::string &buffer, const DumpOptions &options, unsigned threads, std::ostream *output) const;
+      void write_json_objects(JsonWriter &writer, JsonSchema::JsonSchema schema, bool lines, std::size_t first, std::size_t last, std::ostream *output) const;
+      void write_json_columns(JsonWriter &writer, std::ostream *output) const;
+      void write_binary_stream(std::ostream &output);
+      bool write_tiled_stream(std::ostream &output, const DumpOptions &options);
+      bool add_coordinates(SupportedTypes::SupportedTypes type, const double *coordinates, std::size_t count);
+      bool add_flat(SupportedTypes::SupportedTypes type, const double *values, std::size_t count);
+      bool add_columns(SupportedTypes::SupportedTypes type, const double *const *columns, std::size_t rows);
+      void append_order(SupportedTypes::SupportedTypes type, std::size_t count);
+      Mark mark() const;
+      void rollback(const Mark &mark);
+
+      template <class T>
+      CGAL_list<T> &store()
+      {
+         return std::get<CGAL_list<T>>(this->_stores);
+      }
+
+      template <class T>
+      const CGAL_list<T> &store() const
+      {
+         return std::get<CGAL_list<T>>(this->_stores);
+      }
+
+      /**
+       * \brief call visitor with the store of the given type
+       */
+      template <class Visitor>
+      void visit_store(SupportedTypes::SupportedTypes type, Visitor &&visitor)
+      {
+         switch (type)
          {
-            delete(*it);
+         case SupportedTypes::point_2:          visitor(std::get<SupportedTypes::point_2>(this->_stores)); break;
+         case SupportedTypes::line_2:           visitor(std::get<SupportedTypes::line_2>(this->_stores)); break;
+         case SupportedTypes::segment_2:        visitor(std::get<SupportedTypes::segment_2>(this->_stores)); break;
+         case SupportedTypes::weighted_point_2: visitor(std::get<SupportedTypes::weighted_point_2>(this->_stores)); break;
+         case SupportedTypes::vector_2:         visitor(std::get<SupportedTypes::vector_2>(this->_stores)); break;
+         case SupportedTypes::direction_2:      visitor(std::get<SupportedTypes::direction_2>(this->_stores)); break;
+         case SupportedTypes::ray_2:            visitor(std::get<SupportedTypes::ray_2>(this->_stores)); break;
+         case SupportedTypes::triangle_2:       visitor(std::get<SupportedTypes::triangle_2>(this->_stores)); break;
+         case SupportedTypes::iso_rectangle_2:  visitor(std::get<SupportedTypes::iso_rectangle_2>(this->_stores)); break;
+         case SupportedTypes::circle_2:         visitor(std::get<SupportedTypes::circle_2>(this->_stores)); break;
          }
       }
 
-	   template <class T>
-	   CGAL_list<T> get_objects( T object )
-	   {
-		   CGAL_list<T> container;
-         for (CGAL_list<JsonCGALBase*>::iterator it = this->_objs.begin(); it < this->_objs.end(); it++)
+      template <class Visitor>
+      void visit_store(SupportedTypes::SupportedTypes type, Visitor &&visitor) const
+      {
+         const_cast<BasicJsonCGAL *>(this)->visit_store(type, [&visitor](const auto &store) { visitor(store); });
+      }
+
+      template <class T>
+      static constexpr SupportedTypes::SupportedTypes type_of()
+      {
+         static_assert(store_index<T, ObjectStores>::value == type_traits<T>::type, "object stores must follow SupportedTypes order");
+         return type_traits<T>::type;
+      }
+
+      /* mutable so that const accessors can decode lazily loaded types. The decode
+         is not synchronised, see LoadOptions::lazy */
+      mutable ObjectStores _stores;
+      mutable CGAL_list<ObjectRun> _order;
+      mutable std::size_t _size = 0;
+      mutable PendingObjects _pending[supported_type_count];
+      /* built on demand, dropped whenever objects are added or removed. Const
+         members only touch it through the atomic shared_ptr functions */
+      mutable std::shared_ptr<const SpatialObjects> _spatial;
+      /* region objects must reach into to be kept, set while loading with a region */
+      const CGAL::Bbox_2 *_region = nullptr;
+      /* objects decoded and dropped for lying outside the region */
+      std::size_t _filtered = 0;
+
+   public:
+      bool load(std::string filename, const LoadOptions &options = LoadOptions());
+      bool load(std::string filename, const typename K::Iso_rectangle_2 &region, const LoadOptions &options = LoadOptions());
+      std::future<bool> load_async(std::string filename, const LoadOptions &options = LoadOptions());
+      bool load_from_string(std::string json_string, const LoadOptions &options = LoadOptions());
+      bool load_from_string(std::string json_string, const typename K::Iso_rectangle_2 &region, const LoadOptions &options = LoadOptions());
+      bool dump(std::string filename, const DumpOptions &options = DumpOptions());
+      bool dump(std::string filename, FileFormat::FileFormat format);
+      std::string dump_to_string(const DumpOptions &options = DumpOptions());
+      std::string dump_to_string(FileFormat::FileFormat format);
+      std::size_t size() const { return this->_size; }
+      std::size_t count(SupportedTypes::SupportedTypes type) const;
+      void clear();
+      bool decode_all();
+      void build_index() const;
+      std::vector<ObjectRef> query(const typename K::Iso_rectangle_2 &box) const;
+
+      /**
+       * \brief decode the objects of type T in a geometry file and pass each
+       *        one to callback in file order, without storing them. Objects
+       *        are decoded a batch at a time, so memory use does not grow with
+       *        the file. Objects passed to callback before a parse error are
+       *        not taken back.
+       *
+       * \param filename, the file to read, in any format load accepts
+       * \param callback, called with a const T & for every object of type T
+       * \param options, how the file is read. Lazy and threaded loading do not apply.
+       * \return success/failure
+       */
+      template <class T, class Callback>
+      static bool for_each_object(const std::string &filename, Callback &&callback, const LoadOptions &options = LoadOptions())
+      {
+         BasicJsonCGAL batch;
+         return batch.stream_file(filename, options, [&callback](const BasicJsonCGAL &objects)
+         {
+            for (const T &object : objects.store<T>())
+            {
+               callback(object);
+            }
+         });
+      }
+
+      /**
+       * \brief stored objects of type T that intersect a box, see query(box)
+       *
+       * \return pointers to the objects, valid until objects of type T are added
+       */
+      template <class T>
+      std::vector<const T *> query(const typename K::Iso_rectangle_2 &box) const
+      {
+         std::vector<const T *> found;
+         std::vector<ObjectRef> objects = this->query(box);
+         const CGAL_list<T> &container = this->store<T>();
+         for (const ObjectRef &object : objects)
          {
-            if ((*it)->getType() == object.getType())
+            if (object.type == type_of<T>())
             {
-               T& obj = dynamic_cast<T&>(*(*it));
-               container.push_back(obj);
+               found.push_back(&container[object.index]);
             }
          }
-		   return container;
-	   };
+         return found;
+      }
+
+      /**
+       * \brief number of stored objects of type T
+       */
+      template <class T>
+      std::size_t count() const
+      {
+         return this->store<T>().size() + this->_pending[type_of<T>()].count;
+      }
+
+      /**
+       * \brief make room for count objects of type T so adding them does not
+       *        reallocate the store
+       */
+      template <class T>
+      void reserve(std::size_t count)
+      {
+         this->decode_pending(type_of<T>());
+         this->store<T>().reserve(count);
+      }
+
+      /**
+       * \brief zero-copy access to the stored objects of type T, usable
+       *        directly as an iterator range in CGAL algorithms. After a lazy
+       *        load the first access decodes the objects of type T.
+       */
+      template <class T>
+      ObjectView<T> view() const
+      {
+         this->decode_pending(type_of<T>());
+         const CGAL_list<T> &container = this->store<T>();
+         return ObjectView<T>(container.begin(), container.end());
+      }
+
+      /**
+       * \brief copy of the stored objects of type T, see view() for access
+       *        without copying
+       */
+      template <class T>
+      CGAL_list<T> get_objects()
+      {
+         this->decode_pending(type_of<T>());
+         return this->store<T>();
+      }
+
+      /**
+       * \brief copy of the stored objects of type T. The object only names the
+       *        type, kept for existing callers of get_objects<T>(T())
+       */
+      template <class T>
+      CGAL_list<T> get_objects([[maybe_unused]] T object)
+      {
+         return this->get_objects<T>();
+      }
       
+      /**
+       * \brief append a range of objects. The values may be wrapper types or
+       *        plain kernel types, e.g. K::Point_2, and are converted once
+       *        as they are copied into the store.
+       */
+      template <class Iterator>
+      void add_objects(Iterator first, Iterator last)
+      {
+         typedef typename wrapper_of<typename std::iterator_traits<Iterator>::value_type, K>::type T;
+         this->decode_pending(type_of<T>());
+         CGAL_list<T> &container = this->store<T>();
+         std::size_t start = container.size();
+         if constexpr (std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<Iterator>::iterator_category>::value)
+         {
+            reserve_additional(container, static_cast<std::size_t>(std::distance(first, last)));
+         }
+         for (; first != last; ++first)
+         {
+            container.emplace_back(*first);
+         }
+         this->append_order(type_of<T>(), container.size() - start);
+      }
+
       template <class T>
-      void add_objects(CGAL_list<T> objects)
-	   {
-         T *new_obj;
-		   for (CGAL_list<T>::iterator it = objects.begin(); it < objects.end(); it++)
-		   {
-            new_obj = new T;
-            *new_obj = *it;
-			   this->_objs.push_back(new_obj);
-		   }
-		   return;
-	   };
+      void add_objects(const CGAL_list<T> &objects)
+      {
+         this->add_objects(objects.begin(), objects.end());
+      }
+
+      /**
+       * \brief append a container of objects, taking over its storage when
+       *        no objects of that type are stored or reserved yet
+       */
+      template <class T>
+      void add_objects(CGAL_list<T> &&objects)
+      {
+         typedef typename wrapper_of<T, K>::type Wrapper;
+         this->decode_pending(type_of<Wrapper>());
+         CGAL_list<Wrapper> &container = this->store<Wrapper>();
+         if constexpr (std::is_same<T, Wrapper>::value)
+         {
+            if (container.empty() && container.capacity() < objects.size())
+            {
+               std::size_t count = objects.size();
+               container = std::move(objects);
+               this->append_order(type_of<T>(), count);
+               return;
+            }
+         }
+         this->add_objects(std::make_move_iterator(objects.begin()), std::make_move_iterator(objects.end()));
+      }
+
+      /**
+       * \brief construct one object of type T in place from its constructor arguments
+       *
+       * \return reference to the new object, valid until more objects of type T are added
+       */
+      template <class T, class... Args>
+      T &emplace_object(Args &&... args)
+      {
+         this->decode_pending(type_of<T>());
+         T &object = this->store<T>().emplace_back(std::forward<Args>(args)...);
+         this->append_order(type_of<T>(), 1);
+         return object;
+      }
    };
+
+   /* container for the default kernel */
+   typedef BasicJsonCGAL<Kernel> JsonCGAL;
 };
 
 
@@ -0,0 +1,298 @@
+/**
+ * \file JsonCGALBinary.cpp
+ * \author Graham Riches (graham.riches@live.com)
+ * \brief encoding primitives for the native binary geometry format
+ * \version 0.1
+ * \date 2026-10-17
+ *
+ * \copyright Copyright (c) 2020
+ *
+ */
+
+#include <cstring>
+
+#include "JsonCGALBinary.h"
+
+namespace JsonCGAL
+{
+   /* number of values converted per write when the host is big endian */
+   static const std::size_t swap_chunk_size = 512;
+
+   static bool host_is_little_endian()
+   {
+      const std::uint16_t probe = 1;
+      unsigned char first;
+      std::memcpy(&first, &probe, 1);
+      return first == 1;
+   }
+
+   static void store_le(unsigned char *bytes, std::uint64_t value, std::size_t size)
+   {
+      for (std::size_t i = 0; i < size; i++)
+      {
+         bytes[i] = static_cast<unsigned char>(value >> (8 * i));
+      }
+   }
+
+   static std::uint64_t load_le(const unsigned char *bytes, std::size_t size)
+   {
+      std::uint64_t value = 0;
+      for (std::size_t i = 0; i < size; i++)
+      {
+         value |= static_cast<std::uint64_t>(bytes[i]) << (8 * i);
+      }
+      return value;
+   }
+
+   static bool read_exact(std::istream &input, unsigned char *bytes, std::size_t size)
+   {
+      input.read(reinterpret_cast<char *>(bytes), static_cast<std::streamsize>(size));
+      return static_cast<std::size_t>(input.gcount()) == size;
+   }
+
+   /**
+    * \brief check for the binary format magic at the start of a buffer
+    *
+    * \param data start of the buffer
+    * \param size number of bytes available
+    * \return true if the data is in the binary format
+    */
+   bool is_binary_format(const char *data, std::size_t size)
+   {
+      return size >= sizeof(binary_magic) && std::memcmp(data, binary_magic, sizeof(binary_magic)) == 0;
+   }
+
+   void write_binary_header(std::ostream &output, const BinaryHeader &header)
+   {
+      unsigned char bytes[binary_header_size];
+      std::memcpy(bytes, binary_magic, sizeof(binary_magic));
+      store_le(bytes + 4, header.version, 2);
+      store_le(bytes + 6, header.flags, 2);
+      store_le(bytes + 8, header.block_count, 8);
+      output.write(reinterpret_cast<const char *>(bytes), sizeof(bytes));
+   }
+
+   bool read_binary_header(std::istream &input, BinaryHeader &header)
+   {
+      unsigned char bytes[binary_header_size];
+      if (!read_exact(input, bytes, sizeof(bytes)) || !is_binary_format(reinterpret_cast<const char *>(bytes), sizeof(bytes)))
+      {
+         return false;
+      }
+      header.version = static_cast<std::uint16_t>(load_le(bytes + 4, 2));
+      header.flags = static_cast<std::uint16_t>(load_le(bytes + 6, 2));
+      header.block_count = load_le(bytes + 8, 8);
+      return true;
+   }
+
+   void write_binary_block_header(std::ostream &output, const BinaryBlockHeader &header)
+   {
+      unsigned char bytes[binary_block_header_size] = {};
+      bytes[0] = header.type;
+      store_le(bytes + 4, header.values_per_object, 4);
+      store_le(bytes + 8, header.object_count, 8);
+      output.write(reinterpret_cast<const char *>(bytes), sizeof(bytes));
+   }
+
+   bool read_binary_block_header(std::istream &input, BinaryBlockHeader &header)
+   {
+      unsigned char bytes[binary_block_header_size];
+      if (!read_exact(input, bytes, sizeof(bytes)))
+      {
+         return false;
+      }
+      header.type = bytes[0];
+      header.values_per_object = static_cast<std::uint32_t>(load_le(bytes + 4, 4));
+      header.object_count = load_le(bytes + 8, 8);
+      return true;
+   }
+
+   /**
+    * \brief write floating point values as little endian IEEE-754 values
+    *
+    * \param output stream to write to
+    * \param values values to write
+    * \param count number of values
+    */
+   template <class Value, class Bits>
+   static void write_values(std::ostream &output, const Value *values, std::size_t count)
+   {
+      static_assert(sizeof(Value) == sizeof(Bits), "values are written through an integer of the same size");
+      if (host_is_little_endian())
+      {
+         output.write(reinterpret_cast<const char *>(values), static_cast<std::streamsize>(count * sizeof(Value)));
+         return;
+      }
+      unsigned char bytes[swap_chunk_size * sizeof(Value)];
+      while (count > 0)
+      {
+         std::size_t chunk = (count < swap_chunk_size) ? count : swap_chunk_size;
+         for (std::size_t i = 0; i < chunk; i++)
+         {
+            Bits bits;
+            std::memcpy(&bits, &values[i], sizeof(bits));
+            store_le(bytes + i * sizeof(Value), bits, sizeof(Value));
+         }
+         output.write(reinterpret_cast<const char *>(bytes), static_cast<std::streamsize>(chunk * sizeof(Value)));
+         values += chunk;
+         count -= chunk;
+      }
+   }
+
+   /**
+    * \brief read little endian IEEE-754 values
+    *
+    * \param input stream to read from
+    * \param values destination for the values
+    * \param count number of values
+    * \return false if the stream ended early
+    */
+   template <class Value, class Bits>
+   static bool read_values(std::istream &input, Value *values, std::size_t count)
+   {
+      if (!read_exact(input, reinterpret_cast<unsigned char *>(values), count * sizeof(Value)))
+      {
+         return false;
+      }
+      if (!host_is_little_endian())
+      {
+         for (std::size_t i = 0; i < count; i++)
+         {
+            Bits bits = static_cast<Bits>(load_le(reinterpret_cast<const unsigned char *>(&values[i]), sizeof(Value)));
+            std::memcpy(&values[i], &bits, sizeof(bits));
+         }
+      }
+      return true;
+   }
+
+   void write_binary_values(std::ostream &output, const double *values, std::size_t count)
+   {
+      write_values<double, std::uint64_t>(output, values, count);
+   }
+
+   void write_binary_values(std::ostream &output, const float *values, std::size_t count)
+   {
+      write_values<float, std::uint32_t>(output, values, count);
+   }
+
+   bool read_binary_values(std::istream &input, double *values, std::size_t count)
+   {
+      return read_values<double, std::uint64_t>(input, values, count);
+   }
+
+   bool read_binary_values(std::istream &input, float *values, std::size_t count)
+   {
+      return read_values<float, std::uint32_t>(input, values, count);
+   }
+
+   /**
+    * \brief check for the tiled format magic at the start of a buffer
+    *
+    * \param data start of the buffer
+    * \param size number of bytes available
+    * \return true if the data is in the tiled format
+    */
+   bool is_tiled_format(const char *data, std::size_t size)
+   {
+      return size >= sizeof(tiled_magic) && std::memcmp(data, tiled_magic, sizeof(tiled_magic)) == 0;
+   }
+
+   void write_tiled_header(std::ostream &output)
+   {
+      unsigned char bytes[tiled_header_size] = {};
+      std::memcpy(bytes, tiled_magic, sizeof(tiled_magic));
+      store_le(bytes + 4, tiled_version, 2);
+      output.write(reinterpret_cast<const char *>(bytes), sizeof(bytes));
+   }
+
+   static void store_double(unsigned char *bytes, double value)
+   {
+      std::uint64_t bits;
+      std::memcpy(&bits, &value, sizeof(bits));
+      store_le(bytes, bits, sizeof(bits));
+   }
+
+   static double load_double(const unsigned char *bytes)
+   {
+      std::uint64_t bits = load_le(bytes, sizeof(bits));
+      double value;
+      std::memcpy(&value, &bits, sizeof(value));
+      return value;
+   }
+
+   /**
+    * \brief write the tile index and trailer that end a tiled file
+    *
+    * \param output stream to write to
+    * \param tiles bounds and location of every tile, in file order
+    * \param index_offset file offset the index is written at
+    */
+   void write_tile_index(std::ostream &output, const std::vector<TileEntry> &tiles, std::uint64_t index_offset)
+   {
+      for (const TileEntry &tile : tiles)
+      {
+         unsigned char bytes[tile_entry_size];
+         store_double(bytes, tile.xmin);
+         store_double(bytes + 8, tile.ymin);
+         store_double(bytes + 16, tile.xmax);
+         store_double(bytes + 24, tile.ymax);
+         store_le(bytes + 32, tile.offset, 8);
+         store_le(bytes + 40, tile.size, 8);
+         store_le(bytes + 48, tile.object_count, 8);
+         output.write(reinterpret_cast<const char *>(bytes), sizeof(bytes));
+      }
+      unsigned char trailer[tile_trailer_size] = {};
+      store_le(trailer, tiles.size(), 8);
+      store_le(trailer + 8, index_offset, 8);
+      std::memcpy(trailer + 16, tiled_magic, sizeof(tiled_magic));
+      store_le(trailer + 20, tiled_version, 2);
+      output.write(reinterpret_cast<const char *>(trailer), sizeof(trailer));
+   }
+
+   /**
+    * \brief read the tile index of a tiled file, seeking to it from the end
+    *        of the file. Every tile must lie between the header and the index.
+    *
+    * \param input seekable stream over the whole file
+    * \param size size of the file in bytes
+    * \param tiles receives the tile entries in file order
+    * \return false if the header, index or trailer is invalid
+    */
+   bool read_tile_index(std::istream &input, std::uint64_t size, std::vector<TileEntry> &tiles)
+   {
+      unsigned char header[tiled_header_size];
+      unsigned char trailer[tile_trailer_size];
+      if (size < tiled_header_size + tile_trailer_size || !input.seekg(0) || !read_exact(input, header, sizeof(header)) ||
+          !is_tiled_format(reinterpret_cast<const char *>(header), sizeof(header)) || load_le(header + 4, 2) != tiled_version ||
+          !input.seekg(static_cast<std::streamoff>(size - tile_trailer_size)) || !read_exact(input, trailer, sizeof(trailer)) ||
+          !is_tiled_format(reinterpret_cast<const char *>(trailer + 16), sizeof(tiled_magic)) || load_le(trailer + 20, 2) != tiled_version)
+      {
+         return false;
+      }
+      std::uint64_t count = load_le(trailer, 8);
+      std::uint64_t index_offset = load_le(trailer + 8, 8);
+      std::uint64_t index_end = size - tile_trailer_size;
+      if (index_offset < tiled_header_size || index_offset > index_end || (index_end - index_offset) / tile_entry_size != count ||
+          (index_end - index_offset) % tile_entry_size != 0 || !input.seekg(static_cast<std::streamoff>(index_offset)))
+      {
+         return false;
+      }
+
+      tiles.resize(static_cast<std::size_t>(count));
+      for (TileEntry &tile : tiles)
+      {
+         unsigned char bytes[tile_entry_size];
+         if (!read_exact(input, bytes, sizeof(bytes)))
+         {
+            return false;
+         }
+         tile = TileEntry{load_double(bytes), load_double(bytes + 8), load_double(bytes + 16), load_double(bytes + 24),
+                          load_le(bytes + 32, 8), load_le(bytes + 40, 8), load_le(bytes + 48, 8)};
+         if (tile.offset < tiled_header_size || tile.offset > index_offset || tile.size > index_offset - tile.offset)
+         {
+            return false;
+         }
+      }
+      return true;
+   }
+};
@@ -0,0 +1,106 @@
+/**
+ * \file JsonCGALBinary.h
+ * \author Graham Riches (graham.riches@live.com)
+ * \brief encoding primitives for the native binary geometry format
+ * \version 0.1
+ * \date 2026-10-17
+ *
+ * \copyright Copyright (c) 2020
+ *
+ */
+
+#ifndef __JSON_CGAL_BINARY_H
+#define __JSON_CGAL_BINARY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+namespace JsonCGAL
+{
+   /*
+    * binary geometry format, all values little endian:
+    *
+    *    header: char magic[4] = "JCGB", uint16 version, uint16 flags, uint64 block count
+    *    block:  uint8 type, uint8 reserved[3], uint32 values per object, uint64 object count,
+    *            then object count * values per object doubles, or floats when the
+    *            header has binary_flag_float32 set
+    *
+    * blocks follow the insertion order of the container, one block per run of
+    * consecutively added objects of the same type. The values of each object
+    * are its flat coordinate layout (see flatten() in JsonCGALTypes.h).
+    */
+   static const char binary_magic[4] = {'J', 'C', 'G', 'B'};
+   static const std::uint16_t binary_version = 1;
+   static const std::size_t binary_header_size = 16;
+   static const std::size_t binary_block_header_size = 16;
+
+   /* header flags */
+   static const std::uint16_t binary_flag_float32 = 1 << 0;
+   static const std::uint16_t binary_known_flags = binary_flag_float32;
+
+   struct BinaryHeader
+   {
+      std::uint16_t version;
+      std::uint16_t flags;
+      std::uint64_t block_count;
+   };
+
+   struct BinaryBlockHeader
+   {
+      std::uint8_t type;
+      std::uint32_t values_per_object;
+      std::uint64_t object_count;
+   };
+
+   /*
+    * tiled geometry format, all values little endian:
+    *
+    *    header:  char magic[4] = "JCGT", uint16 version, uint16 reserved
+    *    tiles:   tile count binary geometry streams as above, each decodable on
+    *             its own and optionally gzip or zstd compressed on its own
+    *    index:   per tile: double xmin, ymin, xmax, ymax, uint64 offset,
+    *             uint64 size, uint64 object count
+    *    trailer: uint64 tile count, uint64 index offset, char magic[4] = "JCGT",
+    *             uint16 version, uint16 reserved
+    *
+    * tile bounds cover the extent of every object in the tile. Lines, rays,
+    * vectors and directions go in one last tile with infinite bounds. The
+    * trailer is at a fixed distance from the end of the file, so a reader
+    * finds the index without reading the tiles.
+    */
+   static const char tiled_magic[4] = {'J', 'C', 'G', 'T'};
+   static const std::uint16_t tiled_version = 1;
+   static const std::size_t tiled_header_size = 8;
+   static const std::size_t tile_entry_size = 56;
+   static const std::size_t tile_trailer_size = 24;
+
+   struct TileEntry
+   {
+      double xmin;
+      double ymin;
+      double xmax;
+      double ymax;
+      std::uint64_t offset;
+      std::uint64_t size;
+      std::uint64_t object_count;
+   };
+
+   bool is_binary_format(const char *data, std::size_t size);
+   void write_binary_header(std::ostream &output, const BinaryHeader &header);
+   bool read_binary_header(std::istream &input, BinaryHeader &header);
+   void write_binary_block_header(std::ostream &output, const BinaryBlockHeader &header);
+   bool read_binary_block_header(std::istream &input, BinaryBlockHeader &header);
+   void write_binary_values(std::ostream &output, const double *values, std::size_t count);
+   void write_binary_values(std::ostream &output, const float *values, std::size_t count);
+   bool read_binary_values(std::istream &input, double *values, std::size_t count);
+   bool read_binary_values(std::istream &input, float *values, std::size_t count);
+   bool is_tiled_format(const char *data, std::size_t size);
+   void write_tiled_header(std::ostream &output);
+   void write_tile_index(std::ostream &output, const std::vector<TileEntry> &tiles, std::uint64_t index_offset);
+   bool read_tile_index(std::istream &input, std::uint64_t size, std::vector<TileEntry> &tiles);
+};
+
+#endif /* __JSON_CGAL_BINARY_H */
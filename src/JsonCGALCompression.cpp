@@ -0,0 +1,445 @@
+/**
+ * \file JsonCGALCompression.cpp
+ * \author Graham Riches (graham.riches@live.com)
+ * \brief gzip and zstd stream buffers for compressed geometry files
+ * \version 0.1
+ * \date 2026-10-17
+ *
+ * \copyright Copyright (c) 2020
+ *
+ */
+
+#include <cstring>
+#include <thread>
+
+#include "JsonCGALCompression.h"
+
+#ifdef JSON_CGAL_ZLIB
+#include <zlib.h>
+#endif
+#ifdef JSON_CGAL_ZSTD
+#include <zstd.h>
+#endif
+
+namespace JsonCGAL
+{
+   /* compressed bytes read from the source at a time */
+   static const std::size_t decompress_input_size = 1 << 18;
+   /* decompressed bytes produced at a time */
+   static const std::size_t decompress_output_size = 1 << 20;
+
+   static const unsigned char gzip_magic[2] = {0x1F, 0x8B};
+   static const unsigned char zstd_magic[4] = {0x28, 0xB5, 0x2F, 0xFD};
+
+   /**
+    * \brief detect compressed data from its first bytes
+    *
+    * \param data start of the data
+    * \param size number of bytes available
+    * \return the compression, or none for uncompressed data
+    */
+   Compression::Compression compressed_format(const char *data, std::size_t size)
+   {
+      if (size >= sizeof(gzip_magic) && std::memcmp(data, gzip_magic, sizeof(gzip_magic)) == 0)
+      {
+         return Compression::gzip;
+      }
+      if (size >= sizeof(zstd_magic) && std::memcmp(data, zstd_magic, sizeof(zstd_magic)) == 0)
+      {
+         return Compression::zstd;
+      }
+      return Compression::none;
+   }
+
+   /**
+    * \brief check if the library was built with support for a compression
+    */
+   bool compression_supported(Compression::Compression format)
+   {
+      switch (format)
+      {
+      case Compression::none:
+         return true;
+      case Compression::gzip:
+#ifdef JSON_CGAL_ZLIB
+         return true;
+#else
+         return false;
+#endif
+      case Compression::zstd:
+#ifdef JSON_CGAL_ZSTD
+         return true;
+#else
+         return false;
+#endif
+      }
+      return false;
+   }
+
+   const char *compression_name(Compression::Compression format)
+   {
+      switch (format)
+      {
+      case Compression::gzip:
+         return "gzip";
+      case Compression::zstd:
+         return "zstd";
+      default:
+         return "none";
+      }
+   }
+
+   /**
+    * \brief decompression state of one stream. Input is handed over in
+    *        blocks through in and in_size, and consumed by decode().
+    */
+   struct DecompressStreamBuffer::Decoder
+   {
+      Compression::Compression format;
+      const char *in = nullptr;
+      std::size_t in_size = 0;
+      /* the last gzip member or zstd frame ended and no new one was started */
+      bool complete = false;
+      /* the last call filled the output, so more output may be waiting */
+      bool output_pending = false;
+#ifdef JSON_CGAL_ZLIB
+      z_stream zlib = {};
+#endif
+#ifdef JSON_CGAL_ZSTD
+      ZSTD_DStream *zstd = nullptr;
+#endif
+
+      explicit Decoder(Compression::Compression compression) : format(compression)
+      {
+#ifdef JSON_CGAL_ZLIB
+         /* 32 added to the window bits reads gzip and zlib headers */
+         if (this->format == Compression::gzip && inflateInit2(&this->zlib, MAX_WBITS + 32) != Z_OK)
+         {
+            this->format = Compression::none;
+         }
+#endif
+#ifdef JSON_CGAL_ZSTD
+         if (this->format == Compression::zstd)
+         {
+            this->zstd = ZSTD_createDStream();
+            if (this->zstd == nullptr || ZSTD_isError(ZSTD_initDStream(this->zstd)))
+            {
+               this->format = Compression::none;
+            }
+         }
+#endif
+      }
+
+      ~Decoder()
+      {
+#ifdef JSON_CGAL_ZLIB
+         if (this->format == Compression::gzip)
+         {
+            inflateEnd(&this->zlib);
+         }
+#endif
+#ifdef JSON_CGAL_ZSTD
+         if (this->zstd != nullptr)
+         {
+            ZSTD_freeDStream(this->zstd);
+         }
+#endif
+      }
+
+      /**
+       * \brief decompress from the pending input into out
+       *
+       * \param out the output block
+       * \param capacity size of the output block
+       * \param produced receives the number of bytes written to out
+       * \return false on corrupt input or an unsupported compression
+       */
+      bool decode(char *out, std::size_t capacity, std::size_t &produced)
+      {
+         produced = 0;
+         switch (this->format)
+         {
+#ifdef JSON_CGAL_ZLIB
+         case Compression::gzip:
+         {
+            this->zlib.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(this->in));
+            this->zlib.avail_in = static_cast<uInt>(this->in_size);
+            this->zlib.next_out = reinterpret_cast<Bytef *>(out);
+            this->zlib.avail_out = static_cast<uInt>(capacity);
+            int result = inflate(&this->zlib, Z_NO_FLUSH);
+            std::size_t consumed = this->in_size - this->zlib.avail_in;
+            produced = capacity - this->zlib.avail_out;
+            this->in += consumed;
+            this->in_size -= consumed;
+            if (result == Z_STREAM_END)
+            {
+               /* another member may follow */
+               this->complete = true;
+               this->output_pending = false;
+               return inflateReset(&this->zlib) == Z_OK;
+            }
+            if (result != Z_OK && result != Z_BUF_ERROR)
+            {
+               return false;
+            }
+            if (consumed > 0 || produced > 0)
+            {
+               this->complete = false;
+            }
+            this->output_pending = (produced == capacity);
+            return true;
+         }
+#endif
+#ifdef JSON_CGAL_ZSTD
+         case Compression::zstd:
+         {
+            ZSTD_inBuffer input = {this->in, this->in_size, 0};
+            ZSTD_outBuffer output = {out, capacity, 0};
+            std::size_t result = ZSTD_decompressStream(this->zstd, &output, &input);
+            if (ZSTD_isError(result))
+            {
+               return false;
+            }
+            this->in += input.pos;
+            this->in_size -= input.pos;
+            produced = output.pos;
+            if (input.pos > 0 || output.pos > 0)
+            {
+               /* zero once a frame is decoded and flushed */
+               this->complete = (result == 0);
+            }
+            this->output_pending = (produced == capacity);
+            return true;
+         }
+#endif
+         default:
+            (void)out;
+            (void)capacity;
+            return false;
+         }
+      }
+   };
+
+   /**
+    * \param source the compressed stream, read only through this buffer
+    * \param format the compression of the source, see compressed_format()
+    */
+   DecompressStreamBuffer::DecompressStreamBuffer(std::streambuf &source, Compression::Compression format)
+      : _source(source), _decoder(new Decoder(format)), _input(decompress_input_size), _output(decompress_output_size)
+   {
+   }
+
+   DecompressStreamBuffer::~DecompressStreamBuffer() = default;
+
+   /**
+    * \brief read the next block of compressed input
+    *
+    * \return false at the end of the source
+    */
+   bool DecompressStreamBuffer::fill_input()
+   {
+      std::streamsize read = this->_source.sgetn(this->_input.data(), static_cast<std::streamsize>(this->_input.size()));
+      if (read <= 0)
+      {
+         return false;
+      }
+      this->_decoder->in = this->_input.data();
+      this->_decoder->in_size = static_cast<std::size_t>(read);
+      return true;
+   }
+
+   /**
+    * \brief decompress the next block of output
+    *
+    * \return the next character, or eof at the end of the stream
+    */
+   DecompressStreamBuffer::int_type DecompressStreamBuffer::underflow()
+   {
+      if (this->gptr() < this->egptr())
+      {
+         return traits_type::to_int_type(*this->gptr());
+      }
+      while (!this->_end)
+      {
+         Decoder &decoder = *this->_decoder;
+         if (decoder.in_size == 0 && !decoder.output_pending && !this->fill_input())
+         {
+            /* the source ended, cleanly only between members or frames */
+            this->_end = true;
+            this->_failed = !decoder.complete;
+            break;
+         }
+         std::size_t produced;
+         if (!decoder.decode(this->_output.data(), this->_output.size(), produced))
+         {
+            this->_end = true;
+            this->_failed = true;
+            break;
+         }
+         if (produced > 0)
+         {
+            this->setg(this->_output.data(), this->_output.data(), this->_output.data() + produced);
+            return traits_type::to_int_type(*this->gptr());
+         }
+      }
+      return traits_type::eof();
+   }
+
+   /**
+    * \brief look at the decompressed bytes available without consuming them,
+    *        e.g. to detect the format of the decompressed data
+    *
+    * \param data receives the start of the available bytes
+    * \return number of bytes available, 0 at the end of the stream
+    */
+   std::size_t DecompressStreamBuffer::peek(const char *&data)
+   {
+      if (this->gptr() == this->egptr())
+      {
+         this->underflow();
+      }
+      data = this->gptr();
+      return static_cast<std::size_t>(this->egptr() - this->gptr());
+   }
+
+   /**
+    * \brief compress one block into a complete gzip member or zstd frame
+    *
+    * \param format the compression to use
+    * \param level compression level, 0 for the library default
+    * \param block the uncompressed bytes
+    * \param compressed receives the compressed bytes
+    * \return success
+    */
+   static bool compress_block(Compression::Compression format, int level, const std::string &block, std::string &compressed)
+   {
+      switch (format)
+      {
+#ifdef JSON_CGAL_ZLIB
+      case Compression::gzip:
+      {
+         z_stream zlib = {};
+         /* 16 added to the window bits writes a gzip header */
+         if (deflateInit2(&zlib, (level == 0) ? Z_DEFAULT_COMPRESSION : level, Z_DEFLATED, MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+         {
+            return false;
+         }
+         compressed.resize(deflateBound(&zlib, static_cast<uLong>(block.size())));
+         zlib.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(block.data()));
+         zlib.avail_in = static_cast<uInt>(block.size());
+         zlib.next_out = reinterpret_cast<Bytef *>(&compressed[0]);
+         zlib.avail_out = static_cast<uInt>(compressed.size());
+         bool done = (deflate(&zlib, Z_FINISH) == Z_STREAM_END);
+         compressed.resize(zlib.total_out);
+         deflateEnd(&zlib);
+         return done;
+      }
+#endif
+#ifdef JSON_CGAL_ZSTD
+      case Compression::zstd:
+      {
+         compressed.resize(ZSTD_compressBound(block.size()));
+         std::size_t size = ZSTD_compress(&compressed[0], compressed.size(), block.data(), block.size(), level);
+         if (ZSTD_isError(size))
+         {
+            return false;
+         }
+         compressed.resize(size);
+         return true;
+      }
+#endif
+      default:
+         (void)level;
+         (void)block;
+         (void)compressed;
+         return false;
+      }
+   }
+
+   /**
+    * \param sink the stream receiving the compressed bytes
+    * \param format the compression to use, must be supported
+    * \param level compression level, 0 for the library default
+    * \param threads number of blocks compressed in parallel
+    */
+   CompressStreamBuffer::CompressStreamBuffer(std::streambuf &sink, Compression::Compression format, int level, unsigned threads)
+      : _sink(sink), _format(format), _level(level), _threads((threads > 0) ? threads : 1)
+   {
+      this->_blocks.emplace_back(compress_block_size, '\0');
+      this->setp(&this->_blocks.back()[0], &this->_blocks.back()[0] + compress_block_size);
+   }
+
+   /**
+    * \brief start a new block once the current one is full, compressing the
+    *        waiting blocks when there is one for every thread
+    */
+   CompressStreamBuffer::int_type CompressStreamBuffer::overflow(int_type c)
+   {
+      if (this->_failed)
+      {
+         return traits_type::eof();
+      }
+      if (this->_blocks.size() == this->_threads)
+      {
+         this->compress_blocks();
+      }
+      this->_blocks.emplace_back(compress_block_size, '\0');
+      this->setp(&this->_blocks.back()[0], &this->_blocks.back()[0] + compress_block_size);
+      if (!traits_type::eq_int_type(c, traits_type::eof()))
+      {
+         *this->pptr() = traits_type::to_char_type(c);
+         this->pbump(1);
+      }
+      return traits_type::not_eof(c);
+   }
+
+   /**
+    * \brief compress the waiting blocks in parallel and write them in order.
+    *        The last block is cut to the bytes written into it.
+    */
+   void CompressStreamBuffer::compress_blocks()
+   {
+      this->_blocks.back().resize(static_cast<std::size_t>(this->pptr() - this->pbase()));
+      if (this->_blocks.size() > 1 && this->_blocks.back().empty())
+      {
+         this->_blocks.pop_back();
+      }
+      std::size_t count = this->_blocks.size();
+      std::vector<std::string> compressed(count);
+      std::vector<char> done(count, 0);
+      std::vector<std::thread> workers;
+      for (std::size_t i = 1; i < count; i++)
+      {
+         workers.emplace_back([&, i]() { done[i] = compress_block(this->_format, this->_level, this->_blocks[i], compressed[i]); });
+      }
+      done[0] = compress_block(this->_format, this->_level, this->_blocks[0], compressed[0]);
+      for (std::thread &worker : workers)
+      {
+         worker.join();
+      }
+
+      for (std::size_t i = 0; i < count && !this->_failed; i++)
+      {
+         std::streamsize size = static_cast<std::streamsize>(compressed[i].size());
+         this->_failed = !done[i] || this->_sink.sputn(compressed[i].data(), size) != size;
+      }
+      this->_blocks.clear();
+      this->setp(nullptr, nullptr);
+      this->_written = true;
+   }
+
+   /**
+    * \brief compress and write everything left. Output with no bytes is
+    *        still written as one empty member or frame.
+    *
+    * \return false if compressing or writing any block failed
+    */
+   bool CompressStreamBuffer::finish()
+   {
+      if (!this->_failed && (this->_blocks.size() > 1 || this->pptr() != this->pbase() || !this->_written))
+      {
+         this->compress_blocks();
+      }
+      return !this->_failed && this->_sink.pubsync() == 0;
+   }
+};
@@ -0,0 +1,107 @@
+/**
+ * \file JsonCGALCompression.h
+ * \author Graham Riches (graham.riches@live.com)
+ * \brief gzip and zstd stream buffers for compressed geometry files
+ * \version 0.1
+ * \date 2026-10-17
+ *
+ * \copyright Copyright (c) 2020
+ *
+ */
+
+#ifndef __JSON_CGAL_COMPRESSION_H
+#define __JSON_CGAL_COMPRESSION_H
+
+#include <cstddef>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace JsonCGAL
+{
+   /* compression applied on top of a file format. gzip needs zlib (JSON_CGAL_ZLIB)
+      and zstd needs libzstd (JSON_CGAL_ZSTD) when the library is built */
+   namespace Compression
+   {
+      enum Compression
+      {
+         none,
+         gzip,
+         zstd,
+      };
+   };
+
+   /* uncompressed bytes compressed as one independent block */
+   static const std::size_t compress_block_size = 1 << 22;
+
+   Compression::Compression compressed_format(const char *data, std::size_t size);
+   bool compression_supported(Compression::Compression format);
+   const char *compression_name(Compression::Compression format);
+
+   /**
+    * \brief read only stream buffer that decompresses a gzip or zstd source
+    *        as it is read. Concatenated gzip members and zstd frames are
+    *        read as one stream. Corrupt or truncated input ends the stream
+    *        early and sets failed().
+    */
+   class DecompressStreamBuffer : public std::streambuf
+   {
+      public:
+         DecompressStreamBuffer(std::streambuf &source, Compression::Compression format);
+         DecompressStreamBuffer(const DecompressStreamBuffer &) = delete;
+         DecompressStreamBuffer &operator=(const DecompressStreamBuffer &) = delete;
+         ~DecompressStreamBuffer();
+
+         std::size_t peek(const char *&data);
+         bool failed() const { return this->_failed; }
+
+      protected:
+         int_type underflow() override;
+
+      private:
+         struct Decoder;
+
+         bool fill_input();
+
+         std::streambuf &_source;
+         std::unique_ptr<Decoder> _decoder;
+         std::vector<char> _input;
+         std::vector<char> _output;
+         bool _failed = false;
+         bool _end = false;
+   };
+
+   /**
+    * \brief write only stream buffer that compresses its output into gzip
+    *        members or zstd frames of compress_block_size bytes each, and
+    *        compresses up to threads blocks at a time in parallel. finish()
+    *        must be called after the last write.
+    */
+   class CompressStreamBuffer : public std::streambuf
+   {
+      public:
+         CompressStreamBuffer(std::streambuf &sink, Compression::Compression format, int level, unsigned threads);
+         CompressStreamBuffer(const CompressStreamBuffer &) = delete;
+         CompressStreamBuffer &operator=(const CompressStreamBuffer &) = delete;
+
+         bool finish();
+
+      protected:
+         int_type overflow(int_type c) override;
+
+      private:
+         void compress_blocks();
+
+         std::streambuf &_sink;
+         Compression::Compression _format;
+         int _level;
+         unsigned _threads;
+         /* full blocks waiting to be compressed, the last one is being filled */
+         std::vector<std::string> _blocks;
+         bool _written = false;
+         bool _failed = false;
+   };
+};
+
+#endif /* __JSON_CGAL_COMPRESSION_H */
@@ -4,16 +4,16 @@
  * \brief contains the string to enum mapping for the json CGAL library
  * \version 0.1
  * \date 2020-05-07
- * 
+ *
  * @copyright Copyright (c) 2020
- * 
+ *
  */
 
 #ifndef __JSON_CGAL_MAP_H
 #define __JSON_CGAL_MAP_H
 
-#include <map>
-#include <string>
+#include <cstddef>
+#include <string_view>
 
 namespace JsonCGAL
 {
@@ -34,17 +34,127 @@ namespace JsonCGAL
 			circle_2,
 		};
 	};
-	
-	/* create the json string key to enum mapping */
-	static std::map<std::string, SupportedTypes::SupportedTypes> key_map = 
-   { 
-      {"point_2", SupportedTypes::point_2},                   {"line_2", SupportedTypes::line_2},         {"segment_2", SupportedTypes::segment_2},
-      {"weighted_point_2", SupportedTypes::weighted_point_2}, {"vector_2", SupportedTypes::vector_2},     {"direction_2", SupportedTypes::direction_2},
-      {"ray_2", SupportedTypes::ray_2},                       {"triangle_2", SupportedTypes::triangle_2}, {"iso_rectangle_2", SupportedTypes::iso_rectangle_2},
-      {"circle_2", SupportedTypes::circle_2},
-   };
 
+	/* json "type" key of each supported type, indexed by SupportedTypes */
+	inline constexpr std::string_view type_keys[] =
+	{
+		"point_2", "line_2", "segment_2", "weighted_point_2", "vector_2",
+		"direction_2", "ray_2", "triangle_2", "iso_rectangle_2", "circle_2",
+	};
+
+	static constexpr std::size_t type_key_count = sizeof(type_keys) / sizeof(type_keys[0]);
+
+	/**
+	 * \brief json "type" key of a supported type
+	 */
+	constexpr const char *type_key(SupportedTypes::SupportedTypes type)
+	{
+		return type_keys[type].data();
+	}
+
+	/*
+	 * name of each value in the flat coordinate layout of a type (see flatten()
+	 * in JsonCGALTypes.h), used as the column keys of the columnar json schema
+	 */
+	static constexpr std::size_t max_type_columns = 6;
+
+	inline constexpr std::string_view type_columns[][max_type_columns] =
+	{
+		{"x", "y"},
+		{"a", "b", "c"},
+		{"x0", "y0", "x1", "y1"},
+		{"x", "y", "weight"},
+		{"x", "y"},
+		{"dx", "dy"},
+		{"x0", "y0", "x1", "y1"},
+		{"x0", "y0", "x1", "y1", "x2", "y2"},
+		{"xmin", "ymin", "xmax", "ymax"},
+		{"x", "y", "squared_radius", "orientation"},
+	};
+
+	inline constexpr std::size_t type_column_counts[] = {2, 3, 4, 3, 2, 2, 4, 6, 4, 4};
+
+	/**
+	 * \brief index of a named column in the flat coordinate layout of a type
+	 *
+	 * \return the column index, or -1 if the type has no such column
+	 */
+	constexpr int find_column(SupportedTypes::SupportedTypes type, std::string_view name)
+	{
+		for (std::size_t column = 0; column < type_column_counts[type]; column++)
+		{
+			if (type_columns[type][column] == name)
+			{
+				return static_cast<int>(column);
+			}
+		}
+		return -1;
+	}
+
+	/*
+	 * perfect hash from a json "type" key to its SupportedTypes value. Every
+	 * key starts with a different letter, so the low bits of the first
+	 * character select a unique slot and one compare confirms the match.
+	 */
+	static constexpr std::size_t type_hash_size = 32;
+
+	constexpr std::size_t type_hash(std::string_view key)
+	{
+		return key.empty() ? 0 : static_cast<unsigned char>(key[0]) % type_hash_size;
+	}
+
+	struct TypeHashTable
+	{
+		signed char slots[type_hash_size];
+	};
+
+	constexpr TypeHashTable make_type_hash_table()
+	{
+		TypeHashTable table = {};
+		for (std::size_t slot = 0; slot < type_hash_size; slot++)
+		{
+			table.slots[slot] = -1;
+		}
+		for (std::size_t type = 0; type < type_key_count; type++)
+		{
+			table.slots[type_hash(type_keys[type])] = static_cast<signed char>(type);
+		}
+		return table;
+	}
+
+	inline constexpr TypeHashTable type_hash_table = make_type_hash_table();
+
+	constexpr bool type_hash_is_perfect()
+	{
+		for (std::size_t type = 0; type < type_key_count; type++)
+		{
+			if (type_hash_table.slots[type_hash(type_keys[type])] != static_cast<signed char>(type))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	static_assert(type_hash_is_perfect(), "json type keys collide in type_hash, pick a new hash");
+
+	/**
+	 * \brief look up the SupportedTypes value of a json "type" key
+	 *
+	 * \param key the json key
+	 * \param type set to the matching type
+	 * \return false if the key is not a supported type
+	 */
+	constexpr bool find_type(std::string_view key, SupportedTypes::SupportedTypes &type)
+	{
+		signed char slot = type_hash_table.slots[type_hash(key)];
+		if (slot < 0 || type_keys[slot] != key)
+		{
+			return false;
+		}
+		type = static_cast<SupportedTypes::SupportedTypes>(slot);
+		return true;
+	}
 };
 
 #endif /* __JSON_CGAL_MAP_H */
-
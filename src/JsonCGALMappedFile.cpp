@@ -0,0 +1,155 @@
+/**
+ * \file JsonCGALMappedFile.cpp
+ * \author Graham Riches (graham.riches@live.com)
+ * \brief read only memory mapping of an input file
+ * \version 0.1
+ * \date 2026-10-17
+ *
+ * \copyright Copyright (c) 2020
+ *
+ */
+
+#include "JsonCGALMappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace JsonCGAL
+{
+#ifdef _WIN32
+   /**
+    * \brief map a file into memory
+    *
+    * \param filename the file to map
+    * \param huge_pages ignored, file mappings cannot use large pages on windows
+    * \return false if the file could not be mapped
+    */
+   bool MappedFile::open(const std::string &filename, bool huge_pages)
+   {
+      LARGE_INTEGER size;
+      this->close();
+      HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+      if (file == INVALID_HANDLE_VALUE)
+      {
+         return false;
+      }
+      if (!GetFileSizeEx(file, &size))
+      {
+         CloseHandle(file);
+         return false;
+      }
+      this->_file = file;
+      this->_size = static_cast<std::size_t>(size.QuadPart);
+      this->_open = true;
+      if (this->_size == 0)
+      {
+         return true;
+      }
+      this->_mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+      if (this->_mapping != NULL)
+      {
+         this->_data = static_cast<const char *>(MapViewOfFile(this->_mapping, FILE_MAP_READ, 0, 0, 0));
+      }
+      if (this->_data == nullptr)
+      {
+         this->close();
+         return false;
+      }
+      return true;
+   }
+
+   /**
+    * \brief release the mapping
+    */
+   void MappedFile::close()
+   {
+      if (this->_data != nullptr)
+      {
+         UnmapViewOfFile(this->_data);
+      }
+      if (this->_mapping != nullptr)
+      {
+         CloseHandle(this->_mapping);
+      }
+      if (this->_file != nullptr)
+      {
+         CloseHandle(this->_file);
+      }
+      this->_data = nullptr;
+      this->_mapping = nullptr;
+      this->_file = nullptr;
+      this->_size = 0;
+      this->_open = false;
+   }
+#else
+   /**
+    * \brief map a file into memory
+    *
+    * \param filename the file to map
+    * \param huge_pages request transparent huge pages for the mapping where
+    *        the kernel supports them for file backed memory
+    * \return false if the file could not be mapped
+    */
+   bool MappedFile::open(const std::string &filename, bool huge_pages)
+   {
+      struct stat status;
+      this->close();
+      int fd = ::open(filename.c_str(), O_RDONLY);
+      if (fd < 0)
+      {
+         return false;
+      }
+      if (fstat(fd, &status) != 0 || !S_ISREG(status.st_mode))
+      {
+         ::close(fd);
+         return false;
+      }
+      this->_size = static_cast<std::size_t>(status.st_size);
+      if (this->_size > 0)
+      {
+         void *data = mmap(nullptr, this->_size, PROT_READ, MAP_PRIVATE, fd, 0);
+         if (data == MAP_FAILED)
+         {
+            ::close(fd);
+            this->_size = 0;
+            return false;
+         }
+         madvise(data, this->_size, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+         if (huge_pages)
+         {
+            madvise(data, this->_size, MADV_HUGEPAGE);
+         }
+#endif
+         this->_data = static_cast<const char *>(data);
+      }
+      /* the mapping stays valid after the descriptor is closed */
+      ::close(fd);
+      this->_open = true;
+      return true;
+   }
+
+   /**
+    * \brief release the mapping
+    */
+   void MappedFile::close()
+   {
+      if (this->_data != nullptr)
+      {
+         munmap(const_cast<char *>(this->_data), this->_size);
+      }
+      this->_data = nullptr;
+      this->_size = 0;
+      this->_open = false;
+   }
+#endif
+};
@@ -0,0 +1,49 @@
+/**
+ * \file JsonCGALMappedFile.h
+ * \author Graham Riches (graham.riches@live.com)
+ * \brief read only memory mapping of an input file
+ * \version 0.1
+ * \date 2026-10-17
+ *
+ * \copyright Copyright (c) 2020
+ *
+ */
+
+#ifndef __JSON_CGAL_MAPPED_FILE_H
+#define __JSON_CGAL_MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+namespace JsonCGAL
+{
+   /**
+    * \brief maps a whole file read only into memory. The mapping is advised
+    *        for sequential access and is released when the object is destroyed.
+    */
+   class MappedFile
+   {
+      public:
+         MappedFile() = default;
+         MappedFile(const MappedFile &) = delete;
+         MappedFile &operator=(const MappedFile &) = delete;
+         ~MappedFile() { this->close(); }
+
+         bool open(const std::string &filename, bool huge_pages = false);
+         void close();
+         bool is_open() const { return this->_open; }
+         const char *data() const { return this->_data; }
+         std::size_t size() const { return this->_size; }
+
+      private:
+         const char *_data = nullptr;
+         std::size_t _size = 0;
+         bool _open = false;
+#ifdef _WIN32
+         void *_file = nullptr;
+         void *_mapping = nullptr;
+#endif
+   };
+};
+
+#endif /* __JSON_CGAL_MAPPED_FILE_H */
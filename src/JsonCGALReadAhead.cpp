@@ -0,0 +1,139 @@
+/**
+ * \file JsonCGALReadAhead.cpp
+ * \author Graham Riches (graham.riches@live.com)
+ * \brief reader threads that fetch input ahead of the parser
+ * \version 0.1
+ * \date 2026-10-17
+ *
+ * \copyright Copyright (c) 2020
+ *
+ */
+
+#include "JsonCGALReadAhead.h"
+
+namespace JsonCGAL
+{
+   /* stride used to touch a mapping, no larger than any page size in use */
+   static const std::size_t read_ahead_page_size = 4096;
+
+   /**
+    * \brief start reading the source on a new thread
+    *
+    * \param source the stream buffer to read
+    * \param block_size bytes in each of the two blocks
+    */
+   ReadAheadStreamBuffer::ReadAheadStreamBuffer(std::streambuf &source, std::size_t block_size)
+      : _source(source)
+   {
+      this->_blocks[0].resize(block_size);
+      this->_blocks[1].resize(block_size);
+      this->_reader = std::thread(&ReadAheadStreamBuffer::read_blocks, this);
+   }
+
+   /**
+    * \brief stop the reader thread, also when the input was not read to the end
+    */
+   ReadAheadStreamBuffer::~ReadAheadStreamBuffer()
+   {
+      {
+         std::lock_guard<std::mutex> lock(this->_mutex);
+         this->_stop = true;
+      }
+      this->_changed.notify_all();
+      this->_reader.join();
+   }
+
+   /**
+    * \brief reader thread, fills the blocks in turn until the source ends. An
+    *        empty block marks the end of the source.
+    */
+   void ReadAheadStreamBuffer::read_blocks()
+   {
+      for (int block = 0;; block ^= 1)
+      {
+         {
+            std::unique_lock<std::mutex> lock(this->_mutex);
+            this->_changed.wait(lock, [&] { return this->_stop || !this->_full[block]; });
+            if (this->_stop)
+            {
+               return;
+            }
+         }
+         std::streamsize read = this->_source.sgetn(this->_blocks[block].data(), static_cast<std::streamsize>(this->_blocks[block].size()));
+         {
+            std::lock_guard<std::mutex> lock(this->_mutex);
+            this->_filled[block] = (read > 0) ? static_cast<std::size_t>(read) : 0;
+            this->_full[block] = true;
+         }
+         this->_changed.notify_all();
+         if (read <= 0)
+         {
+            return;
+         }
+      }
+   }
+
+   /**
+    * \brief hand the consumed block back to the reader thread and wait for
+    *        the next one
+    *
+    * \return the next character, or eof at the end of the source
+    */
+   ReadAheadStreamBuffer::int_type ReadAheadStreamBuffer::underflow()
+   {
+      if (this->gptr() < this->egptr())
+      {
+         return traits_type::to_int_type(*this->gptr());
+      }
+      if (this->_end)
+      {
+         return traits_type::eof();
+      }
+
+      std::unique_lock<std::mutex> lock(this->_mutex);
+      if (this->_current >= 0)
+      {
+         this->_full[this->_current] = false;
+         this->_changed.notify_all();
+      }
+      this->_current = (this->_current < 0) ? 0 : this->_current ^ 1;
+      int block = this->_current;
+      this->_changed.wait(lock, [&] { return this->_full[block]; });
+      if (this->_filled[block] == 0)
+      {
+         this->_end = true;
+         return traits_type::eof();
+      }
+      char *begin = this->_blocks[block].data();
+      this->setg(begin, begin, begin + this->_filled[block]);
+      return traits_type::to_int_type(*begin);
+   }
+
+   /**
+    * \brief start touching the pages of a mapping on a new thread
+    *
+    * \param data start of the mapping
+    * \param size bytes in the mapping
+    */
+   MappingReadAhead::MappingReadAhead(const char *data, std::size_t size)
+   {
+      this->_reader = std::thread([this, data, size]()
+      {
+         volatile char sink = 0;
+         for (std::size_t offset = 0; offset < size && !this->_stop.load(std::memory_order_relaxed); offset += read_ahead_page_size)
+         {
+            sink = data[offset];
+         }
+         (void)sink;
+      });
+   }
+
+   /**
+    * \brief stop touching pages, the mapping may be released afterwards
+    */
+   MappingReadAhead::~MappingReadAhead()
+   {
+      this->_stop.store(true, std::memory_order_relaxed);
+      this->_reader.join();
+   }
+};
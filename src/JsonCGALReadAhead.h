@@ -0,0 +1,80 @@
+/**
+ * \file JsonCGALReadAhead.h
+ * \author Graham Riches (graham.riches@live.com)
+ * \brief reader threads that fetch input ahead of the parser
+ * \version 0.1
+ * \date 2026-10-17
+ *
+ * \copyright Copyright (c) 2020
+ *
+ */
+
+#ifndef __JSON_CGAL_READ_AHEAD_H
+#define __JSON_CGAL_READ_AHEAD_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+namespace JsonCGAL
+{
+   /* bytes read by a read ahead thread at a time */
+   static const std::size_t read_ahead_block_size = 1 << 20;
+
+   /**
+    * \brief read only stream buffer that reads its source on a separate
+    *        thread. The thread fills one block while the reader of the buffer
+    *        consumes the other, so reads overlap with parsing. The source must
+    *        outlive the buffer and must not be used while the buffer exists.
+    */
+   class ReadAheadStreamBuffer : public std::streambuf
+   {
+      public:
+         explicit ReadAheadStreamBuffer(std::streambuf &source, std::size_t block_size = read_ahead_block_size);
+         ReadAheadStreamBuffer(const ReadAheadStreamBuffer &) = delete;
+         ReadAheadStreamBuffer &operator=(const ReadAheadStreamBuffer &) = delete;
+         ~ReadAheadStreamBuffer();
+
+      protected:
+         int_type underflow() override;
+
+      private:
+         void read_blocks();
+
+         std::streambuf &_source;
+         std::vector<char> _blocks[2];
+         std::size_t _filled[2] = {};
+         bool _full[2] = {};
+         /* block being consumed, or -1 before the first underflow */
+         int _current = -1;
+         bool _end = false;
+         bool _stop = false;
+         std::mutex _mutex;
+         std::condition_variable _changed;
+         std::thread _reader;
+   };
+
+   /**
+    * \brief touches every page of a memory mapping on a separate thread, so
+    *        the pages are read from disk ahead of the parser walking the
+    *        mapping instead of one fault at a time
+    */
+   class MappingReadAhead
+   {
+      public:
+         MappingReadAhead(const char *data, std::size_t size);
+         MappingReadAhead(const MappingReadAhead &) = delete;
+         MappingReadAhead &operator=(const MappingReadAhead &) = delete;
+         ~MappingReadAhead();
+
+      private:
+         std::atomic<bool> _stop{false};
+         std::thread _reader;
+   };
+};
+
+#endif /* __JSON_CGAL_READ_AHEAD_H */
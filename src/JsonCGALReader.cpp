@@ -0,0 +1,790 @@
+/**
+ * \file JsonCGALReader.cpp
+ * \author Graham Riches (graham.riches@live.com)
+ * \brief geometry specialized json reader for text held in memory
+ * \version 0.1
+ * \date 2026-10-17
+ *
+ * \copyright Copyright (c) 2020
+ *
+ */
+
+#include <charconv>
+#include <cstdint>
+
+#include "JsonCGALReader.h"
+
+/*
+ * SSE2 and NEON are part of the x86-64 and AArch64 baselines, so the vector
+ * scanners below run on any such host. The NEON scanner reduces masks with
+ * vaddv, which only AArch64 has, so 32-bit ARM uses the scalar loops like
+ * other targets.
+ */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define JSON_CGAL_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define JSON_CGAL_NEON
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace JsonCGAL
+{
+   /* bytes classified per vector step */
+   static const std::size_t block_size = 16;
+
+   static inline bool is_whitespace(char c)
+   {
+      return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+   }
+
+   static inline bool is_digit(char c)
+   {
+      return c >= '0' && c <= '9';
+   }
+
+   static inline bool is_number_char(char c)
+   {
+      return is_digit(c) || c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-';
+   }
+
+   /* a byte that opens or closes a json container or string */
+   static inline bool is_bracket(char c)
+   {
+      return c == '{' || c == '}' || c == '[' || c == ']' || c == '"';
+   }
+
+   /* a byte that ends the fast path scan of a string: quote, escape, control or non-ascii */
+   static inline bool is_string_stop(char c)
+   {
+      return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20 || static_cast<unsigned char>(c) >= 0x80;
+   }
+
+   /* msvc has __popcnt64 only on x64 and _BitScanForward64 only on 64-bit targets */
+   static inline unsigned bit_count(std::uint64_t mask)
+   {
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+      return static_cast<unsigned>(__popcnt64(mask));
+#elif defined(_MSC_VER) && !defined(__clang__)
+      mask = mask - ((mask >> 1) & 0x5555555555555555ull);
+      mask = (mask & 0x3333333333333333ull) + ((mask >> 2) & 0x3333333333333333ull);
+      mask = (mask + (mask >> 4)) & 0x0f0f0f0f0f0f0f0full;
+      return static_cast<unsigned>((mask * 0x0101010101010101ull) >> 56);
+#else
+      return static_cast<unsigned>(__builtin_popcountll(mask));
+#endif
+   }
+
+   static inline unsigned first_set_bit64(std::uint64_t mask)
+   {
+#if defined(_MSC_VER) && !defined(__clang__) && (defined(_M_X64) || defined(_M_ARM64))
+      unsigned long index;
+      _BitScanForward64(&index, mask);
+      return static_cast<unsigned>(index);
+#elif defined(_MSC_VER) && !defined(__clang__)
+      unsigned long index;
+      if (_BitScanForward(&index, static_cast<unsigned long>(mask)))
+      {
+         return static_cast<unsigned>(index);
+      }
+      _BitScanForward(&index, static_cast<unsigned long>(mask >> 32));
+      return static_cast<unsigned>(index) + 32;
+#else
+      return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+   }
+
+   /* bit i set if an odd number of bits at or below i are set */
+   static inline std::uint64_t prefix_xor(std::uint64_t mask)
+   {
+      mask ^= mask << 1;
+      mask ^= mask << 2;
+      mask ^= mask << 4;
+      mask ^= mask << 8;
+      mask ^= mask << 16;
+      mask ^= mask << 32;
+      return mask;
+   }
+
+   static inline unsigned first_set_bit(unsigned mask)
+   {
+#if defined(_MSC_VER) && !defined(__clang__)
+      unsigned long index;
+      _BitScanForward(&index, mask);
+      return static_cast<unsigned>(index);
+#else
+      return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+   }
+
+#if defined(JSON_CGAL_SSE2)
+   /* bit i set if byte i of the block is a json whitespace character */
+   static inline unsigned whitespace_mask(const char *block)
+   {
+      __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block));
+      __m128i match = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\n'))),
+                                   _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('\r')), _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\t'))));
+      return static_cast<unsigned>(_mm_movemask_epi8(match));
+   }
+
+   /* bit i set if byte i of the block can be part of a json number */
+   static inline unsigned number_mask(const char *block)
+   {
+      __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block));
+      __m128i digits = _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(bytes, _mm_set1_epi8('9' + 1)));
+      __m128i signs = _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('-')), _mm_cmpeq_epi8(bytes, _mm_set1_epi8('+')));
+      __m128i others = _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('.')),
+                                    _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('e')), _mm_cmpeq_epi8(bytes, _mm_set1_epi8('E'))));
+      return static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(digits, _mm_or_si128(signs, others))));
+   }
+
+   /* bits set for the brackets, braces and quotes, and for the commas and colons of a block */
+   static inline void structure_masks(const char *block, unsigned &brackets, unsigned &separators)
+   {
+      __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block));
+      /* setting bit 5 maps '[' to '{' and ']' to '}' */
+      __m128i folded = _mm_or_si128(bytes, _mm_set1_epi8(0x20));
+      __m128i open_close = _mm_or_si128(_mm_cmpeq_epi8(folded, _mm_set1_epi8('{')), _mm_cmpeq_epi8(folded, _mm_set1_epi8('}')));
+      brackets = static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(open_close, _mm_cmpeq_epi8(bytes, _mm_set1_epi8('"')))));
+      separators = static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(',')), _mm_cmpeq_epi8(bytes, _mm_set1_epi8(':')))));
+   }
+
+   /* bits set for the quotes, backslashes, opening and closing brackets of a block */
+   static inline void container_masks(const char *block, unsigned &quotes, unsigned &backslashes, unsigned &opens, unsigned &closes)
+   {
+      __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block));
+      __m128i folded = _mm_or_si128(bytes, _mm_set1_epi8(0x20));
+      quotes = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('"'))));
+      backslashes = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('\\'))));
+      opens = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(folded, _mm_set1_epi8('{'))));
+      closes = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(folded, _mm_set1_epi8('}'))));
+   }
+
+   /* bit i set if byte i of the block ends a fast path string scan */
+   static inline unsigned string_stop_mask(const char *block)
+   {
+      __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block));
+      /* signed compare catches both control characters and bytes >= 0x80 */
+      __m128i stop = _mm_or_si128(_mm_cmplt_epi8(bytes, _mm_set1_epi8(0x20)),
+                                  _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('"')), _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\\'))));
+      return static_cast<unsigned>(_mm_movemask_epi8(stop));
+   }
+#elif defined(JSON_CGAL_NEON)
+   /* pack the high bit of each byte lane into a 16 bit mask */
+   static inline unsigned lane_mask(uint8x16_t match)
+   {
+      static const uint8_t weights[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+      uint8x16_t bits = vandq_u8(match, vld1q_u8(weights));
+      return static_cast<unsigned>(vaddv_u8(vget_low_u8(bits))) | (static_cast<unsigned>(vaddv_u8(vget_high_u8(bits))) << 8);
+   }
+
+   static inline unsigned whitespace_mask(const char *block)
+   {
+      uint8x16_t bytes = vld1q_u8(reinterpret_cast<const uint8_t *>(block));
+      uint8x16_t match = vorrq_u8(vorrq_u8(vceqq_u8(bytes, vdupq_n_u8(' ')), vceqq_u8(bytes, vdupq_n_u8('\n'))),
+                                  vorrq_u8(vceqq_u8(bytes, vdupq_n_u8('\r')), vceqq_u8(bytes, vdupq_n_u8('\t'))));
+      return lane_mask(match);
+   }
+
+   static inline unsigned number_mask(const char *block)
+   {
+      uint8x16_t bytes = vld1q_u8(reinterpret_cast<const uint8_t *>(block));
+      uint8x16_t digits = vcltq_u8(vsubq_u8(bytes, vdupq_n_u8('0')), vdupq_n_u8(10));
+      uint8x16_t signs = vorrq_u8(vceqq_u8(bytes, vdupq_n_u8('-')), vceqq_u8(bytes, vdupq_n_u8('+')));
+      uint8x16_t others = vorrq_u8(vceqq_u8(bytes, vdupq_n_u8('.')), vorrq_u8(vceqq_u8(bytes, vdupq_n_u8('e')), vceqq_u8(bytes, vdupq_n_u8('E'))));
+      return lane_mask(vorrq_u8(digits, vorrq_u8(signs, others)));
+   }
+
+   static inline void structure_masks(const char *block, unsigned &brackets, unsigned &separators)
+   {
+      uint8x16_t bytes = vld1q_u8(reinterpret_cast<const uint8_t *>(block));
+      uint8x16_t folded = vorrq_u8(bytes, vdupq_n_u8(0x20));
+      uint8x16_t open_close = vorrq_u8(vceqq_u8(folded, vdupq_n_u8('{')), vceqq_u8(folded, vdupq_n_u8('}')));
+      brackets = lane_mask(vorrq_u8(open_close, vceqq_u8(bytes, vdupq_n_u8('"'))));
+      separators = lane_mask(vorrq_u8(vceqq_u8(bytes, vdupq_n_u8(',')), vceqq_u8(bytes, vdupq_n_u8(':'))));
+   }
+
+   static inline void container_masks(const char *block, unsigned &quotes, unsigned &backslashes, unsigned &opens, unsigned &closes)
+   {
+      uint8x16_t bytes = vld1q_u8(reinterpret_cast<const uint8_t *>(block));
+      uint8x16_t folded = vorrq_u8(bytes, vdupq_n_u8(0x20));
+      quotes = lane_mask(vceqq_u8(bytes, vdupq_n_u8('"')));
+      backslashes = lane_mask(vceqq_u8(bytes, vdupq_n_u8('\\')));
+      opens = lane_mask(vceqq_u8(folded, vdupq_n_u8('{')));
+      closes = lane_mask(vceqq_u8(folded, vdupq_n_u8('}')));
+   }
+
+   static inline unsigned string_stop_mask(const char *block)
+   {
+      uint8x16_t bytes = vld1q_u8(reinterpret_cast<const uint8_t *>(block));
+      uint8x16_t stop = vorrq_u8(vorrq_u8(vcltq_u8(bytes, vdupq_n_u8(0x20)), vcgeq_u8(bytes, vdupq_n_u8(0x80))),
+                                 vorrq_u8(vceqq_u8(bytes, vdupq_n_u8('"')), vceqq_u8(bytes, vdupq_n_u8('\\'))));
+      return lane_mask(stop);
+   }
+#endif
+
+   /**
+    * \brief first byte at or after position that is not json whitespace
+    */
+   const char *skip_json_whitespace(const char *position, const char *end)
+   {
+      /* compact text has no whitespace, so check one byte before vectorizing */
+      if (position == end || !is_whitespace(*position))
+      {
+         return position;
+      }
+#if defined(JSON_CGAL_SSE2) || defined(JSON_CGAL_NEON)
+      while (end - position >= static_cast<std::ptrdiff_t>(block_size))
+      {
+         unsigned mask = ~whitespace_mask(position) & 0xFFFF;
+         if (mask != 0)
+         {
+            return position + first_set_bit(mask);
+         }
+         position += block_size;
+      }
+#endif
+      while (position < end && is_whitespace(*position))
+      {
+         position++;
+      }
+      return position;
+   }
+
+   /**
+    * \brief first byte at or after position that cannot be part of a json number
+    */
+   const char *scan_json_number(const char *position, const char *end)
+   {
+#if defined(JSON_CGAL_SSE2) || defined(JSON_CGAL_NEON)
+      while (end - position >= static_cast<std::ptrdiff_t>(block_size))
+      {
+         unsigned mask = ~number_mask(position) & 0xFFFF;
+         if (mask != 0)
+         {
+            return position + first_set_bit(mask);
+         }
+         position += block_size;
+      }
+#endif
+      while (position < end && is_number_char(*position))
+      {
+         position++;
+      }
+      return position;
+   }
+
+   StructureScanner::StructureScanner(const char *end)
+      : _block(end), _end(end), _brackets(0), _separators(0)
+   {
+   }
+
+   /**
+    * \brief first structural character at or after position. Each block is
+    *        classified once and its masks are reused by the following calls,
+    *        so stepping through nearby characters costs a few bit operations.
+    *
+    * \param position where to start looking
+    * \param separators true to stop at commas and colons as well as at
+    *        brackets, braces and quotes
+    * \return the character, or the end of the text
+    */
+   const char *StructureScanner::next(const char *position, bool separators)
+   {
+#if defined(JSON_CGAL_SSE2) || defined(JSON_CGAL_NEON)
+      for (;;)
+      {
+         if (position >= this->_block && position < this->_block + block_size)
+         {
+            unsigned offset = static_cast<unsigned>(position - this->_block);
+            unsigned mask = (separators ? (this->_brackets | this->_separators) : this->_brackets) >> offset;
+            if (mask != 0)
+            {
+               return position + first_set_bit(mask);
+            }
+            position = this->_block + block_size;
+         }
+         if (this->_end - position < static_cast<std::ptrdiff_t>(block_size))
+         {
+            break;
+         }
+         this->_block = position;
+         structure_masks(position, this->_brackets, this->_separators);
+      }
+#endif
+      while (position < this->_end && !is_bracket(*position) && !(separators && (*position == ',' || *position == ':')))
+      {
+         position++;
+      }
+      return position;
+   }
+
+   /**
+    * \brief skip a json object or array without decoding it. Blocks of 64
+    *        bytes are classified at once: string contents are masked out with
+    *        a prefix xor of the quotes, and a block is stepped through bracket
+    *        by bracket only if the container can close inside it. Blocks with
+    *        escapes are read byte by byte.
+    *
+    * \param position the opening bracket or brace
+    * \param end end of the text
+    * \return one past the matching close, or nullptr if the text ends first
+    */
+   const char *skip_json_container(const char *position, const char *end)
+   {
+      std::size_t depth = 0;
+      bool in_string = false;
+#if defined(JSON_CGAL_SSE2) || defined(JSON_CGAL_NEON)
+      const std::size_t wide_block = 4 * block_size;
+      while (end - position >= static_cast<std::ptrdiff_t>(wide_block))
+      {
+         std::uint64_t quotes = 0, backslashes = 0, opens = 0, closes = 0;
+         for (std::size_t part = 0; part < 4; part++)
+         {
+            unsigned q, b, o, c;
+            container_masks(position + part * block_size, q, b, o, c);
+            quotes |= static_cast<std::uint64_t>(q) << (part * block_size);
+            backslashes |= static_cast<std::uint64_t>(b) << (part * block_size);
+            opens |= static_cast<std::uint64_t>(o) << (part * block_size);
+            closes |= static_cast<std::uint64_t>(c) << (part * block_size);
+         }
+         if (backslashes != 0)
+         {
+            break;
+         }
+         std::uint64_t strings = prefix_xor(quotes) ^ (in_string ? ~std::uint64_t(0) : 0);
+         in_string = (strings >> 63) != 0;
+         opens &= ~strings;
+         closes &= ~strings;
+         if (depth > 0 && bit_count(closes) < depth)
+         {
+            depth += bit_count(opens);
+            depth -= bit_count(closes);
+            position += wide_block;
+            continue;
+         }
+         for (std::uint64_t brackets = opens | closes; brackets != 0; brackets &= brackets - 1)
+         {
+            unsigned bit = first_set_bit64(brackets);
+            if ((opens >> bit) & 1)
+            {
+               depth++;
+            }
+            else if (--depth == 0)
+            {
+               return position + bit + 1;
+            }
+         }
+         position += wide_block;
+      }
+#endif
+      bool escaped = false;
+      for (; position < end; position++)
+      {
+         char c = *position;
+         if (in_string)
+         {
+            if (escaped)
+            {
+               escaped = false;
+            }
+            else if (c == '\\')
+            {
+               escaped = true;
+            }
+            else if (c == '"')
+            {
+               in_string = false;
+            }
+         }
+         else if (c == '"')
+         {
+            in_string = true;
+         }
+         else if (c == '{' || c == '[')
+         {
+            depth++;
+         }
+         else if ((c == '}' || c == ']') && --depth == 0)
+         {
+            return position + 1;
+         }
+      }
+      return nullptr;
+   }
+
+   /**
+    * \brief first quote, escape, control or non-ascii byte at or after position
+    */
+   const char *scan_json_string(const char *position, const char *end)
+   {
+#if defined(JSON_CGAL_SSE2) || defined(JSON_CGAL_NEON)
+      while (end - position >= static_cast<std::ptrdiff_t>(block_size))
+      {
+         unsigned mask = string_stop_mask(position);
+         if (mask != 0)
+         {
+            return position + first_set_bit(mask);
+         }
+         position += block_size;
+      }
+#endif
+      while (position < end && !is_string_stop(*position))
+      {
+         position++;
+      }
+      return position;
+   }
+
+   /* powers of ten that are exact doubles */
+   static const double exact_powers_of_ten[] =
+   {
+      1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+   };
+
+   /**
+    * \brief convert the text [first, last) to a double if it is exactly one
+    *        json number. Decimals with at most 19 significant digits, a
+    *        mantissa below 2^53 and a power of ten up to 22 are converted
+    *        with one exact multiply or divide (Clinger's fast path). Other
+    *        numbers go through std::from_chars. Both round correctly, so the
+    *        value matches the general parser bit for bit.
+    *
+    * \param first start of the number text
+    * \param last end of the number text
+    * \param value receives the number
+    * \return false if the text is not a json number or is out of range
+    */
+   bool parse_json_double(const char *first, const char *last, double &value)
+   {
+      const char *position = first;
+      bool negative = false;
+      bool integer = true;
+      bool truncated = false;
+      std::uint64_t mantissa = 0;
+      int digits = 0;
+      int exponent = 0;
+
+      if (position < last && *position == '-')
+      {
+         negative = true;
+         position++;
+      }
+      if (position == last || !is_digit(*position))
+      {
+         return false;
+      }
+      if (*position == '0')
+      {
+         /* no leading zeros */
+         position++;
+      }
+      else
+      {
+         for (; position < last && is_digit(*position); position++)
+         {
+            if (digits < 19)
+            {
+               mantissa = mantissa * 10 + static_cast<std::uint64_t>(*position - '0');
+               digits++;
+            }
+            else
+            {
+               truncated = true;
+               exponent++;
+            }
+         }
+      }
+      if (position < last && *position == '.')
+      {
+         integer = false;
+         position++;
+         if (position == last || !is_digit(*position))
+         {
+            return false;
+         }
+         for (; position < last && is_digit(*position); position++)
+         {
+            if (digits < 19)
+            {
+               mantissa = mantissa * 10 + static_cast<std::uint64_t>(*position - '0');
+               exponent--;
+               if (mantissa != 0)
+               {
+                  digits++;
+               }
+            }
+            else
+            {
+               truncated = true;
+            }
+         }
+      }
+      if (position < last && (*position == 'e' || *position == 'E'))
+      {
+         bool negative_exponent = false;
+         int written_exponent = 0;
+         integer = false;
+         position++;
+         if (position < last && (*position == '+' || *position == '-'))
+         {
+            negative_exponent = (*position == '-');
+            position++;
+         }
+         if (position == last || !is_digit(*position))
+         {
+            return false;
+         }
+         for (; position < last && is_digit(*position); position++)
+         {
+            if (written_exponent < 100000)
+            {
+               written_exponent = written_exponent * 10 + (*position - '0');
+            }
+         }
+         exponent += negative_exponent ? -written_exponent : written_exponent;
+      }
+      if (position != last)
+      {
+         return false;
+      }
+
+      if (mantissa == 0 && integer)
+      {
+         /* the general parser reads -0 as the integer 0 */
+         value = 0.0;
+         return true;
+      }
+      if (!truncated && mantissa <= (std::uint64_t(1) << 53) && exponent >= -22 && exponent <= 22)
+      {
+         double result = static_cast<double>(mantissa);
+         result = (exponent < 0) ? result / exact_powers_of_ten[-exponent] : result * exact_powers_of_ten[exponent];
+         value = negative ? -result : result;
+         return true;
+      }
+      std::from_chars_result converted = std::from_chars(first, last, value);
+      return converted.ec == std::errc() && converted.ptr == last;
+   }
+
+   JsonReader::JsonReader(const char *data, std::size_t size, ReadLayout::ReadLayout layout)
+      : _position(data), _end(data + size), _layout(layout)
+   {
+   }
+
+   /**
+    * \brief point the reader at new text, keeping its buffers
+    */
+   void JsonReader::reset(const char *data, std::size_t size)
+   {
+      this->_position = data;
+      this->_end = data + size;
+   }
+
+   /**
+    * \brief read a string without escapes, _position is on the opening quote
+    */
+   bool JsonReader::parse_string(std::string &value)
+   {
+      const char *first = this->_position + 1;
+      const char *last = scan_json_string(first, this->_end);
+      if (last == this->_end || *last != '"')
+      {
+         return false;
+      }
+      value.assign(first, last);
+      this->_position = last + 1;
+      return true;
+   }
+
+   bool JsonReader::parse_number(nlohmann::json_sax<nlohmann::json> &sax)
+   {
+      static const std::string no_text;
+      const char *last = scan_json_number(this->_position, this->_end);
+      double value;
+      if (!parse_json_double(this->_position, last, value))
+      {
+         return false;
+      }
+      this->_position = last;
+      return sax.number_float(value, no_text);
+   }
+
+   bool JsonReader::parse_literal(nlohmann::json_sax<nlohmann::json> &sax)
+   {
+      std::size_t available = static_cast<std::size_t>(this->_end - this->_position);
+      if (available >= 4 && std::char_traits<char>::compare(this->_position, "null", 4) == 0)
+      {
+         this->_position += 4;
+         return sax.null();
+      }
+      if (available >= 4 && std::char_traits<char>::compare(this->_position, "true", 4) == 0)
+      {
+         this->_position += 4;
+         return sax.boolean(true);
+      }
+      if (available >= 5 && std::char_traits<char>::compare(this->_position, "false", 5) == 0)
+      {
+         this->_position += 5;
+         return sax.boolean(false);
+      }
+      return false;
+   }
+
+   /**
+    * \brief read the whole text, passing every value to the SAX handler
+    *
+    * \param sax the event handler
+    * \return false if the text is not accepted or the handler stopped the parse
+    */
+   bool JsonReader::parse(nlohmann::json_sax<nlohmann::json> &sax)
+   {
+      const std::size_t unknown_size = static_cast<std::size_t>(-1);
+      bool expect_key = false;
+      this->_stack.clear();
+
+      /* skip a utf-8 byte order mark */
+      if (this->_end - this->_position >= 3 && static_cast<unsigned char>(this->_position[0]) == 0xEF &&
+          static_cast<unsigned char>(this->_position[1]) == 0xBB && static_cast<unsigned char>(this->_position[2]) == 0xBF)
+      {
+         this->_position += 3;
+      }
+      if (this->_layout != ReadLayout::value)
+      {
+         if (!sax.start_array(unknown_size))
+         {
+            return false;
+         }
+         this->_stack.push_back(false);
+      }
+      if (this->_layout == ReadLayout::lines && skip_json_whitespace(this->_position, this->_end) == this->_end)
+      {
+         /* no lines */
+         this->_stack.pop_back();
+         return sax.end_array();
+      }
+
+      for (;;)
+      {
+         /* read one value, or the key in front of it */
+         this->_position = skip_json_whitespace(this->_position, this->_end);
+         if (this->_position == this->_end)
+         {
+            return false;
+         }
+         if (expect_key)
+         {
+            if (*this->_position != '"' || !this->parse_string(this->_string) || !sax.key(this->_string))
+            {
+               return false;
+            }
+            this->_position = skip_json_whitespace(this->_position, this->_end);
+            if (this->_position == this->_end || *this->_position != ':')
+            {
+               return false;
+            }
+            this->_position++;
+            expect_key = false;
+            continue;
+         }
+
+         char c = *this->_position;
+         bool complete = true;
+         bool opened = false;
+         if (c == '{' || c == '[')
+         {
+            bool object = (c == '{');
+            if (!(object ? sax.start_object(unknown_size) : sax.start_array(unknown_size)))
+            {
+               return false;
+            }
+            this->_position = skip_json_whitespace(this->_position + 1, this->_end);
+            if (this->_position < this->_end && *this->_position == (object ? '}' : ']'))
+            {
+               this->_position++;
+               if (!(object ? sax.end_object() : sax.end_array()))
+               {
+                  return false;
+               }
+            }
+            else
+            {
+               this->_stack.push_back(object);
+               expect_key = object;
+               opened = true;
+            }
+         }
+         else if (c == '"')
+         {
+            complete = this->parse_string(this->_string) && sax.string(this->_string);
+         }
+         else if (c == '-' || is_digit(c))
+         {
+            complete = this->parse_number(sax);
+         }
+         else
+         {
+            complete = this->parse_literal(sax);
+         }
+         if (!complete)
+         {
+            return false;
+         }
+         if (opened)
+         {
+            /* read the first element of the new container */
+            continue;
+         }
+
+         /* after a complete value: a separator, or the end of containers */
+         for (;;)
+         {
+            const char *value_end = this->_position;
+            this->_position = skip_json_whitespace(this->_position, this->_end);
+            if (this->_stack.empty())
+            {
+               return this->_position == this->_end;
+            }
+            bool top_level = (this->_layout != ReadLayout::value && this->_stack.size() == 1);
+            if (this->_position == this->_end)
+            {
+               if (top_level)
+               {
+                  this->_stack.pop_back();
+                  return sax.end_array();
+               }
+               return false;
+            }
+            if (top_level && this->_layout == ReadLayout::lines)
+            {
+               /* the next value has to start on a new line */
+               if (std::char_traits<char>::find(value_end, static_cast<std::size_t>(this->_position - value_end), '\n') == nullptr)
+               {
+                  return false;
+               }
+               break;
+            }
+            char next = *this->_position++;
+            bool object = this->_stack.back();
+            if (next == ',')
+            {
+               expect_key = object;
+               break;
+            }
+            if (next != (object ? '}' : ']') || top_level)
+            {
+               return false;
+            }
+            this->_stack.pop_back();
+            if (!(object ? sax.end_object() : sax.end_array()))
+            {
+               return false;
+            }
+         }
+      }
+   }
+};
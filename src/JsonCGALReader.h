@@ -0,0 +1,101 @@
+/**
+ * \file JsonCGALReader.h
+ * \author Graham Riches (graham.riches@live.com)
+ * \brief geometry specialized json reader for text held in memory
+ * \version 0.1
+ * \date 2026-10-17
+ *
+ * \copyright Copyright (c) 2020
+ *
+ */
+
+#ifndef __JSON_CGAL_READER_H
+#define __JSON_CGAL_READER_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "json.hpp"
+
+namespace JsonCGAL
+{
+   /* how the text given to a JsonReader is laid out */
+   namespace ReadLayout
+   {
+      enum ReadLayout
+      {
+         /* a single json value */
+         value,
+         /* a comma separated list of elements read as one array, e.g. a slice from split_json_array */
+         array_elements,
+         /* json lines, one value per line, read as one array */
+         lines,
+      };
+   };
+
+   /**
+    * \brief reads json text held in memory and feeds the same SAX events as
+    *        nlohmann::json::sax_parse. Delimiters, whitespace and digit runs
+    *        are found with SSE2/NEON where available, and numbers are
+    *        converted without the general purpose lexer.
+    *
+    *        Only the subset of json that geometry files use is accepted:
+    *        strings with escapes or non-ascii bytes are not. parse() returns
+    *        false on anything it does not accept, so callers fall back to
+    *        the general parser, which also reports the error.
+    */
+   class JsonReader
+   {
+      public:
+         /**
+          * \param data start of the json text
+          * \param size number of bytes of json text
+          * \param layout how the values in the text are laid out
+          */
+         JsonReader(const char *data, std::size_t size, ReadLayout::ReadLayout layout = ReadLayout::value);
+
+         void reset(const char *data, std::size_t size);
+         bool parse(nlohmann::json_sax<nlohmann::json> &sax);
+
+      private:
+         bool parse_string(std::string &value);
+         bool parse_number(nlohmann::json_sax<nlohmann::json> &sax);
+         bool parse_literal(nlohmann::json_sax<nlohmann::json> &sax);
+
+         const char *_position;
+         const char *_end;
+         ReadLayout::ReadLayout _layout;
+         std::string _string;
+         /* one entry per open container, true for objects */
+         std::vector<bool> _stack;
+   };
+
+   /**
+    * \brief steps through the structural characters of json text (brackets,
+    *        braces, quotes and optionally separators) without looking at the
+    *        values between them. Positions passed to next() must not decrease.
+    */
+   class StructureScanner
+   {
+      public:
+         explicit StructureScanner(const char *end);
+
+         const char *next(const char *position, bool separators);
+
+      private:
+         /* masks of the last classified block */
+         const char *_block;
+         const char *_end;
+         unsigned _brackets;
+         unsigned _separators;
+   };
+
+   const char *skip_json_whitespace(const char *position, const char *end);
+   const char *scan_json_number(const char *position, const char *end);
+   const char *scan_json_string(const char *position, const char *end);
+   const char *skip_json_container(const char *position, const char *end);
+   bool parse_json_double(const char *first, const char *last, double &value);
+};
+
+#endif /* __JSON_CGAL_READER_H */
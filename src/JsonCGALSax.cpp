@@ -0,0 +1,364 @@
+/**
+ * \file JsonCGALSax.cpp
+ * \author Graham Riches (graham.riches@live.com)
+ * \brief SAX event handler that decodes geometry objects directly from the
+ *        json event stream without building an intermediate DOM.
+ * \version 0.1
+ * \date 2026-10-17
+ *
+ * \copyright Copyright (c) 2020
+ *
+ */
+
+#include <iostream>
+
+#include "JsonCGALSax.h"
+
+namespace JsonCGAL
+{
+   /* container depth of the top level array and of each geometry object */
+   static const std::size_t root_depth = 1;
+   static const std::size_t object_depth = 2;
+
+   GeometrySaxHandler::GeometrySaxHandler(GeometrySink &sink)
+      : _sink(sink)
+   {
+   }
+
+   /**
+    * \brief record a semantic (schema) error and stop the parse
+    *
+    * \param message description of the error
+    * \retval false
+    */
+   bool GeometrySaxHandler::fail(const std::string &message)
+   {
+      _error_message = message;
+      return false;
+   }
+
+   /**
+    * \brief print the details of the error that stopped the parse
+    */
+   void GeometrySaxHandler::print_error() const
+   {
+      if (_parse_failed)
+      {
+         /* caught invalid json formatting error */
+         std::cerr << "message: " << _error_message << '\n'
+                   << "exception id: " << _error_id << '\n'
+                   << "byte position of error: " << _error_byte << std::endl;
+      }
+      else
+      {
+         std::cerr << "JsonCGAL Error: " << _error_message << std::endl;
+      }
+   }
+
+   /**
+    * \brief handle a numeric value, keeping it only if it belongs to a
+    *        "coordinates" array of the current object
+    *
+    * \param val the parsed value
+    * \return true to continue parsing
+    */
+   bool GeometrySaxHandler::number(double val)
+   {
+      if (_columnar)
+      {
+         if (_depth <= object_depth)
+         {
+            return fail("invalid columnar geometry block");
+         }
+         if (_depth == _capture_depth)
+         {
+            _columns[_column].push_back(val);
+         }
+         return true;
+      }
+      if (_depth <= root_depth)
+      {
+         return fail("invalid geometry object");
+      }
+      _type_next = false;
+      _capture_next = false;
+      if (_capture_depth != 0 && _depth == _capture_depth)
+      {
+         _coordinates.push_back(val);
+      }
+      return true;
+   }
+
+   bool GeometrySaxHandler::number_integer(number_integer_t val)
+   {
+      return number(static_cast<double>(val));
+   }
+
+   bool GeometrySaxHandler::number_unsigned(number_unsigned_t val)
+   {
+      return number(static_cast<double>(val));
+   }
+
+   bool GeometrySaxHandler::number_float(number_float_t val, const string_t &/*s*/)
+   {
+      return number(val);
+   }
+
+   bool GeometrySaxHandler::null()
+   {
+      if (_columnar && _depth <= object_depth)
+      {
+         return fail("invalid columnar geometry block");
+      }
+      if (_depth <= root_depth)
+      {
+         return fail("invalid geometry object");
+      }
+      _type_next = false;
+      _capture_next = false;
+      return true;
+   }
+
+   bool GeometrySaxHandler::boolean(bool /*val*/)
+   {
+      return this->null();
+   }
+
+   bool GeometrySaxHandler::binary(binary_t &/*val*/)
+   {
+      return this->null();
+   }
+
+   bool GeometrySaxHandler::string(string_t &val)
+   {
+      if (_columnar && _depth <= object_depth)
+      {
+         return fail("invalid columnar geometry block");
+      }
+      if (_depth <= root_depth)
+      {
+         return fail("invalid geometry object");
+      }
+      bool type_next = _type_next;
+      _type_next = false;
+      _capture_next = false;
+      if (type_next)
+      {
+         _have_type = true;
+         _known_type = find_type(val, _type);
+         /* in the compact schema the values array follows the type key */
+         _capture_next = _compact;
+      }
+      return true;
+   }
+
+   bool GeometrySaxHandler::key(string_t &val)
+   {
+      if (_columnar)
+      {
+         return columnar_key(val);
+      }
+      _type_next = (_depth == object_depth && val == "type");
+      _capture_next = (val == "coordinates");
+      return true;
+   }
+
+   bool GeometrySaxHandler::start_object(std::size_t /*elements*/)
+   {
+      if (_depth < root_depth)
+      {
+         /* a top level object holds columnar blocks */
+         _columnar = true;
+         _depth++;
+         return true;
+      }
+      if (_columnar)
+      {
+         if (_depth == object_depth)
+         {
+            return fail("invalid columnar geometry block");
+         }
+         _depth++;
+         return true;
+      }
+      if (_depth == root_depth)
+      {
+         begin_object(false);
+      }
+      _type_next = false;
+      _capture_next = false;
+      _depth++;
+      return true;
+   }
+
+   bool GeometrySaxHandler::end_object()
+   {
+      _depth--;
+      if (_depth == root_depth)
+      {
+         return _columnar ? emit_columns() : emit_object();
+      }
+      return true;
+   }
+
+   bool GeometrySaxHandler::start_array(std::size_t /*elements*/)
+   {
+      if (_columnar)
+      {
+         if (_depth == root_depth)
+         {
+            return fail("invalid columnar geometry block");
+         }
+         _depth++;
+         if (_depth == object_depth + 1 && _column >= 0)
+         {
+            _capture_depth = _depth;
+         }
+         return true;
+      }
+      if (_depth == root_depth)
+      {
+         /* compact schema object, the type key comes first */
+         begin_object(true);
+         _depth++;
+         _type_next = true;
+         _capture_next = false;
+         return true;
+      }
+      _depth++;
+      if (_capture_next)
+      {
+         _capture_depth = _depth;
+      }
+      _type_next = false;
+      _capture_next = false;
+      return true;
+   }
+
+   bool GeometrySaxHandler::end_array()
+   {
+      if (_depth == _capture_depth)
+      {
+         _capture_depth = 0;
+      }
+      _type_next = false;
+      _capture_next = false;
+      _depth--;
+      if (_depth == root_depth && _compact)
+      {
+         return emit_object();
+      }
+      return true;
+   }
+
+   bool GeometrySaxHandler::parse_error(std::size_t position, const std::string &/*last_token*/, const nlohmann::detail::exception &ex)
+   {
+      _parse_failed = true;
+      _error_id = ex.id;
+      _error_byte = position;
+      _error_message = ex.what();
+      return false;
+   }
+
+   /**
+    * \brief reset the per-object state at the start of a top level element
+    *
+    * \param compact true if the element uses the compact schema
+    */
+   void GeometrySaxHandler::begin_object(bool compact)
+   {
+      _compact = compact;
+      _have_type = false;
+      _known_type = false;
+      _capture_depth = 0;
+      _coordinates.clear();
+   }
+
+   /**
+    * \brief handle a key of the columnar schema, a type key in the top level
+    *        object or a column name in a type block
+    *
+    * \param val the key
+    * \return true to continue parsing
+    */
+   bool GeometrySaxHandler::columnar_key(const std::string &val)
+   {
+      if (_depth == root_depth)
+      {
+         if (!find_type(val, _type))
+         {
+            return fail("invalid object type specifier");
+         }
+         for (std::size_t column = 0; column < max_type_columns; column++)
+         {
+            _columns[column].clear();
+            _column_seen[column] = false;
+         }
+      }
+      else if (_depth == object_depth)
+      {
+         _column = find_column(_type, val);
+         if (_column >= 0)
+         {
+            if (_column_seen[_column])
+            {
+               return fail("duplicate column " + val + " for object type " + type_key(_type));
+            }
+            _column_seen[_column] = true;
+         }
+      }
+      return true;
+   }
+
+   /**
+    * \brief pass a completed columnar block on to the sink
+    *
+    * \return true to continue parsing
+    */
+   bool GeometrySaxHandler::emit_columns()
+   {
+      const double *columns[max_type_columns];
+      std::size_t rows = _columns[0].size();
+      for (std::size_t column = 0; column < type_column_counts[_type]; column++)
+      {
+         if (!_column_seen[column])
+         {
+            return fail(std::string("missing column ") + type_columns[_type][column].data() + " for object type " + type_key(_type));
+         }
+         if (_columns[column].size() != rows)
+         {
+            return fail(std::string("columns differ in length for object type ") + type_key(_type));
+         }
+         columns[column] = _columns[column].data();
+      }
+      if (!_sink.add_columns(_type, columns, rows))
+      {
+         return fail(std::string("invalid columns for object type ") + type_key(_type));
+      }
+      return true;
+   }
+
+   /**
+    * \brief pass a completed object on to the sink
+    *
+    * \return true to continue parsing
+    */
+   bool GeometrySaxHandler::emit_object()
+   {
+      if (!_have_type)
+      {
+         return fail("geometry object is missing its type");
+      }
+      if (!_known_type)
+      {
+         return fail("invalid object type specifier");
+      }
+      bool added = _compact ? _sink.add_flat(_type, _coordinates.data(), _coordinates.size())
+                            : _sink.add(_type, _coordinates.data(), _coordinates.size());
+      if (!added)
+      {
+         return fail(std::string("invalid coordinates for object type ") + type_key(_type));
+      }
+      return true;
+   }
+};
@@ -0,0 +1,104 @@
+/**
+ * \file JsonCGALSax.h
+ * \author Graham Riches (graham.riches@live.com)
+ * \brief SAX event handler that decodes geometry objects directly from the
+ *        json event stream without building an intermediate DOM.
+ * \version 0.1
+ * \date 2026-10-17
+ *
+ * \copyright Copyright (c) 2020
+ *
+ */
+
+#ifndef __JSON_CGAL_SAX_H
+#define __JSON_CGAL_SAX_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "json.hpp"
+#include "JsonCGALMap.h"
+
+namespace JsonCGAL
+{
+   /**
+    * \brief receiver for objects decoded by the SAX handler, in document
+    *        order. Objects in the nested schema are passed to add() as their
+    *        type and the values found in their "coordinates" arrays. Objects in
+    *        the compact schema are passed to add_flat() as their type and
+    *        flat coordinate layout (see flatten() in JsonCGALTypes.h).
+    */
+   class GeometrySink
+   {
+      public:
+         virtual ~GeometrySink() = default;
+         virtual bool add(SupportedTypes::SupportedTypes type, const double *coordinates, std::size_t count) = 0;
+         virtual bool add_flat(SupportedTypes::SupportedTypes type, const double *values, std::size_t count) = 0;
+         virtual bool add_columns(SupportedTypes::SupportedTypes type, const double *const *columns, std::size_t rows) = 0;
+   };
+
+   /**
+    * \brief SAX consumer for a top level json array of geometry objects.
+    *        Each element is either a nested schema object, e.g.
+    *        {"type": "point_2", "coordinates": [1.0, 2.0]}, or a compact
+    *        schema array of a type key and flat values, e.g. ["point_2", [1.0, 2.0]].
+    *        A top level json object is read in the columnar schema, one block
+    *        of equal length value columns per type, e.g.
+    *        {"point_2": {"x": [1.0, 3.0], "y": [2.0, 4.0]}}, and each block is
+    *        passed to add_columns() once it is complete.
+    */
+   class GeometrySaxHandler final : public nlohmann::json_sax<nlohmann::json>
+   {
+      public:
+         explicit GeometrySaxHandler(GeometrySink &sink);
+
+         bool null() override;
+         bool boolean(bool val) override;
+         bool number_integer(number_integer_t val) override;
+         bool number_unsigned(number_unsigned_t val) override;
+         bool number_float(number_float_t val, const string_t &s) override;
+         bool string(string_t &val) override;
+         bool binary(binary_t &val) override;
+         bool start_object(std::size_t elements) override;
+         bool key(string_t &val) override;
+         bool end_object() override;
+         bool start_array(std::size_t elements) override;
+         bool end_array() override;
+         bool parse_error(std::size_t position, const std::string &last_token, const nlohmann::detail::exception &ex) override;
+
+         void print_error() const;
+
+      private:
+         bool number(double val);
+         bool fail(const std::string &message);
+         void begin_object(bool compact);
+         bool emit_object();
+         bool columnar_key(const std::string &val);
+         bool emit_columns();
+
+         GeometrySink &_sink;
+         std::size_t _depth = 0;
+         std::size_t _capture_depth = 0;
+         bool _capture_next = false;
+         bool _type_next = false;
+         bool _compact = false;
+         bool _have_type = false;
+         bool _known_type = false;
+         SupportedTypes::SupportedTypes _type = SupportedTypes::point_2;
+         std::vector<double> _coordinates;
+
+         /* columnar schema state, _column is the column receiving values or -1 */
+         bool _columnar = false;
+         int _column = -1;
+         bool _column_seen[max_type_columns] = {};
+         std::vector<double> _columns[max_type_columns];
+
+         bool _parse_failed = false;
+         int _error_id = 0;
+         std::size_t _error_byte = 0;
+         std::string _error_message;
+   };
+};
+
+#endif /* __JSON_CGAL_SAX_H */
@@ -0,0 +1,324 @@
+/**
+ * \file JsonCGALScanner.cpp
+ * \author Graham Riches (graham.riches@live.com)
+ * \brief structural scanning of json geometry text without decoding values
+ * \version 0.1
+ * \date 2026-10-17
+ *
+ * \copyright Copyright (c) 2020
+ *
+ */
+
+#include <cstring>
+
+#include "JsonCGALScanner.h"
+#include "JsonCGALReader.h"
+#include "JsonCGALMap.h"
+
+namespace JsonCGAL
+{
+   /**
+    * \brief split the elements of a top level json array into roughly equal
+    *        sized chunks. Each chunk holds whole elements separated by commas,
+    *        without the enclosing brackets. Elements are stepped over with the
+    *        vector structure scan of skip_json_container, so only the bytes
+    *        between elements are read one at a time. Only the structure is
+    *        checked, the chunks still have to be parsed to find malformed values.
+    *
+    * \param data start of the json text
+    * \param size number of bytes of json text
+    * \param chunk_count number of chunks wanted
+    * \param min_chunk_size smallest chunk worth splitting off, in bytes
+    * \param chunks receives the chunk ranges
+    * \return false if the text is not a single top level array of objects or
+    *         arrays, which geometry elements always are
+    */
+   bool split_json_array(const char *data, std::size_t size, std::size_t chunk_count, std::size_t min_chunk_size, std::vector<ByteRange> &chunks)
+   {
+      const char *position = data;
+      const char *end = data + size;
+      chunks.clear();
+
+      /* skip a utf-8 byte order mark and leading whitespace */
+      if (size >= 3 && static_cast<unsigned char>(data[0]) == 0xEF && static_cast<unsigned char>(data[1]) == 0xBB && static_cast<unsigned char>(data[2]) == 0xBF)
+      {
+         position += 3;
+      }
+      position = skip_json_whitespace(position, end);
+      if (position == end || *position != '[')
+      {
+         return false;
+      }
+      position++;
+
+      std::size_t begin = static_cast<std::size_t>(position - data);
+      std::size_t chunk_size = (chunk_count > 0) ? (size - begin) / chunk_count : size;
+      if (chunk_size < min_chunk_size)
+      {
+         chunk_size = min_chunk_size;
+      }
+      ByteRange chunk = {begin, begin};
+      std::size_t target = begin + chunk_size;
+
+      position = skip_json_whitespace(position, end);
+      if (position < end && *position == ']')
+      {
+         chunk.end = static_cast<std::size_t>(position - data);
+         chunks.push_back(chunk);
+         return skip_json_whitespace(position + 1, end) == end;
+      }
+      for (;;)
+      {
+         if (position == end || (*position != '{' && *position != '['))
+         {
+            return false;
+         }
+         position = skip_json_container(position, end);
+         if (position == nullptr)
+         {
+            return false;
+         }
+
+         /* a separator or the end of the array */
+         position = skip_json_whitespace(position, end);
+         if (position == end)
+         {
+            return false;
+         }
+         std::size_t offset = static_cast<std::size_t>(position - data);
+         if (*position == ']')
+         {
+            chunk.end = offset;
+            chunks.push_back(chunk);
+            /* only whitespace may follow the array */
+            return skip_json_whitespace(position + 1, end) == end;
+         }
+         if (*position != ',')
+         {
+            return false;
+         }
+         if (offset >= target)
+         {
+            chunk.end = offset;
+            chunks.push_back(chunk);
+            chunk.begin = offset + 1;
+            target = offset + chunk_size;
+         }
+         position = skip_json_whitespace(position + 1, end);
+      }
+   }
+
+   /**
+    * \brief index the elements of a top level json array by their type key
+    *        without decoding any values. Elements are geometry objects in the
+    *        nested ({"type": ...}) or compact (["type", ...]) schema, and
+    *        neighbouring elements with the same type key are merged into runs.
+    *
+    * \param data start of the json text
+    * \param size number of bytes of json text
+    * \param runs receives the element runs in file order
+    * \return false if the text is not an array of geometry objects with a
+    *         plain string type key
+    */
+   bool index_json_array(const char *data, std::size_t size, std::vector<ElementRun> &runs)
+   {
+      const char *position = data;
+      const char *end = data + size;
+      StructureScanner structure(end);
+      runs.clear();
+
+      /* skip a utf-8 byte order mark and leading whitespace */
+      if (size >= 3 && static_cast<unsigned char>(data[0]) == 0xEF && static_cast<unsigned char>(data[1]) == 0xBB && static_cast<unsigned char>(data[2]) == 0xBF)
+      {
+         position += 3;
+      }
+      position = skip_json_whitespace(position, end);
+      if (position == end || *position != '[')
+      {
+         return false;
+      }
+      position = skip_json_whitespace(position + 1, end);
+      if (position < end && *position == ']')
+      {
+         return skip_json_whitespace(position + 1, end) == end;
+      }
+
+      for (;;)
+      {
+         if (position == end || (*position != '{' && *position != '['))
+         {
+            return false;
+         }
+         const char *element = position;
+         bool object = (*position == '{');
+         std::size_t depth = 0;
+         /* state of the values directly inside the element */
+         bool after_colon = false;
+         bool type_key = false;
+         bool first_value = !object;
+         const char *type_begin = nullptr;
+         const char *type_end = nullptr;
+
+         do
+         {
+            /* values are not decoded, only the structure between them matters. Separators
+               are only needed to find the type key, elsewhere the nesting is enough */
+            position = structure.next(position, depth == 1 && type_begin == nullptr);
+            if (position == end)
+            {
+               return false;
+            }
+            char c = *position;
+            if (c == '"')
+            {
+               const char *first = position + 1;
+               const char *last = first;
+               for (;;)
+               {
+                  last = scan_json_string(last, end);
+                  if (last == end)
+                  {
+                     return false;
+                  }
+                  if (*last == '"')
+                  {
+                     break;
+                  }
+                  last += (*last == '\\') ? 2 : 1;
+                  if (last > end)
+                  {
+                     return false;
+                  }
+               }
+               if (depth == 1 && type_begin == nullptr)
+               {
+                  if (object && after_colon && type_key)
+                  {
+                     type_begin = first;
+                     type_end = last;
+                  }
+                  else if (object && !after_colon)
+                  {
+                     type_key = (last - first == 4 && std::memcmp(first, "type", 4) == 0);
+                  }
+                  else if (!object && first_value)
+                  {
+                     type_begin = first;
+                     type_end = last;
+                  }
+               }
+               first_value = false;
+               position = last + 1;
+               continue;
+            }
+            switch (c)
+            {
+            case '{':
+            case '[':
+               if (depth > 0)
+               {
+                  /* a value nested in the element, it cannot hold its type key */
+                  position = skip_json_container(position, end);
+                  if (position == nullptr)
+                  {
+                     return false;
+                  }
+                  first_value = false;
+                  continue;
+               }
+               depth++;
+               break;
+            case '}':
+            case ']':
+               depth--;
+               break;
+            case ':':
+               after_colon = after_colon || depth == 1;
+               break;
+            default:
+               /* a comma */
+               if (depth == 1)
+               {
+                  after_colon = false;
+                  type_key = false;
+                  first_value = false;
+               }
+               break;
+            }
+            position++;
+         } while (depth > 0 && position < end);
+
+         if (depth > 0 || type_begin == nullptr)
+         {
+            return false;
+         }
+         std::size_t type_size = static_cast<std::size_t>(type_end - type_begin);
+         if (!runs.empty() && runs.back().type.end - runs.back().type.begin == type_size &&
+             std::memcmp(data + runs.back().type.begin, type_begin, type_size) == 0)
+         {
+            runs.back().elements.end = static_cast<std::size_t>(position - data);
+            runs.back().count++;
+         }
+         else
+         {
+            ElementRun run = {{static_cast<std::size_t>(element - data), static_cast<std::size_t>(position - data)},
+                              {static_cast<std::size_t>(type_begin - data), static_cast<std::size_t>(type_end - data)}, 1};
+            runs.push_back(run);
+         }
+
+         /* a separator or the end of the array */
+         position = skip_json_whitespace(position, end);
+         if (position < end && *position == ',')
+         {
+            position = skip_json_whitespace(position + 1, end);
+            continue;
+         }
+         if (position < end && *position == ']')
+         {
+            return skip_json_whitespace(position + 1, end) == end;
+         }
+         return false;
+      }
+   }
+
+   /**
+    * \brief check from the first bytes of json text if it holds json lines
+    *        (one geometry object per line) rather than a single document. A
+    *        document is an array of objects, or an object whose keys are
+    *        type keys (the columnar schema). A line is a nested schema object,
+    *        whose first key is not a type key, or a compact schema array, whose
+    *        first value is its type key.
+    *
+    * \param data start of the json text
+    * \param size number of bytes available, the start of the text is enough
+    * \return true if the text is json lines
+    */
+   bool is_json_lines(const char *data, std::size_t size)
+   {
+      const char *position = data;
+      const char *end = data + size;
+      if (size >= 3 && static_cast<unsigned char>(data[0]) == 0xEF && static_cast<unsigned char>(data[1]) == 0xBB && static_cast<unsigned char>(data[2]) == 0xBF)
+      {
+         position += 3;
+      }
+      position = skip_json_whitespace(position, end);
+      if (position == end || (*position != '{' && *position != '['))
+      {
+         return false;
+      }
+      bool object = (*position == '{');
+      position = skip_json_whitespace(position + 1, end);
+      if (position == end || *position != '"')
+      {
+         return false;
+      }
+      if (!object)
+      {
+         return true;
+      }
+      const char *key = position + 1;
+      position = scan_json_string(key, end);
+      SupportedTypes::SupportedTypes type;
+      return position < end && *position == '"' && !find_type(std::string_view(key, static_cast<std::size_t>(position - key)), type);
+   }
+};
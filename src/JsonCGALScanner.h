@@ -0,0 +1,42 @@
+/**
+ * \file JsonCGALScanner.h
+ * \author Graham Riches (graham.riches@live.com)
+ * \brief structural scanning of json geometry text without decoding values
+ * \version 0.1
+ * \date 2026-10-17
+ *
+ * \copyright Copyright (c) 2020
+ *
+ */
+
+#ifndef __JSON_CGAL_SCANNER_H
+#define __JSON_CGAL_SCANNER_H
+
+#include <cstddef>
+#include <vector>
+
+namespace JsonCGAL
+{
+   /* byte range [begin, end) of a json text buffer */
+   struct ByteRange
+   {
+      std::size_t begin;
+      std::size_t end;
+   };
+
+   /* consecutive elements of a top level json array that share a type key */
+   struct ElementRun
+   {
+      /* the elements and the commas between them, without the enclosing brackets */
+      ByteRange elements;
+      /* the type key of the elements, without its quotes */
+      ByteRange type;
+      std::size_t count;
+   };
+
+   bool split_json_array(const char *data, std::size_t size, std::size_t chunk_count, std::size_t min_chunk_size, std::vector<ByteRange> &chunks);
+   bool index_json_array(const char *data, std::size_t size, std::vector<ElementRun> &runs);
+   bool is_json_lines(const char *data, std::size_t size);
+};
+
+#endif /* __JSON_CGAL_SCANNER_H */
@@ -0,0 +1,221 @@
+/**
+ * \file JsonCGALSpatialIndex.cpp
+ * \author Graham Riches (graham.riches@live.com)
+ * \brief bulk loaded r-tree over the bounding boxes of stored objects, and
+ *        the quadtree used to split objects into file tiles
+ * \version 0.1
+ * \date 2026-10-17
+ *
+ * \copyright Copyright (c) 2020
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "JsonCGALSpatialIndex.h"
+
+namespace JsonCGAL
+{
+   /* largest float no greater than value */
+   static float round_down(double value)
+   {
+      float rounded = static_cast<float>(value);
+      return (rounded > value) ? std::nextafter(rounded, -std::numeric_limits<float>::infinity()) : rounded;
+   }
+
+   /* smallest float no less than value */
+   static float round_up(double value)
+   {
+      float rounded = static_cast<float>(value);
+      return (rounded < value) ? std::nextafter(rounded, std::numeric_limits<float>::infinity()) : rounded;
+   }
+
+   /**
+    * \brief single precision box containing a double box
+    */
+   IndexBox index_box(double xmin, double ymin, double xmax, double ymax)
+   {
+      return IndexBox{round_down(xmin), round_down(ymin), round_up(xmax), round_up(ymax)};
+   }
+
+   static const IndexBox &box_of(const SpatialIndex::Entry &entry) { return entry.box; }
+
+   template <class Item>
+   static const IndexBox &box_of(const Item &node) { return node.box; }
+
+   /* twice the box centre, enough to order boxes */
+   template <class Item>
+   static float centre_x(const Item &item) { return box_of(item).xmin + box_of(item).xmax; }
+
+   template <class Item>
+   static float centre_y(const Item &item) { return box_of(item).ymin + box_of(item).ymax; }
+
+   /**
+    * \brief order items for STR packing and group them into parent nodes.
+    *        Items are sorted into vertical slices of about sqrt(parents)
+    *        nodes each by x, then by y within each slice, so consecutive
+    *        runs of spatial_node_capacity items are compact.
+    *
+    * \param items the entries or nodes of one level, reordered in place
+    * \param parents receives the nodes of the next level up
+    */
+   template <class Item, class Node>
+   static void pack_level(std::vector<Item> &items, std::vector<Node> &parents)
+   {
+      std::size_t parent_count = (items.size() + spatial_node_capacity - 1) / spatial_node_capacity;
+      std::size_t slice_count = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(parent_count))));
+      std::size_t slice_size = slice_count * spatial_node_capacity;
+
+      std::sort(items.begin(), items.end(), [](const Item &a, const Item &b) { return centre_x(a) < centre_x(b); });
+      for (std::size_t first = 0; first < items.size(); first += slice_size)
+      {
+         std::size_t last = std::min(first + slice_size, items.size());
+         std::sort(items.begin() + first, items.begin() + last, [](const Item &a, const Item &b) { return centre_y(a) < centre_y(b); });
+      }
+
+      parents.clear();
+      parents.reserve(parent_count);
+      for (std::size_t first = 0; first < items.size(); first += spatial_node_capacity)
+      {
+         std::size_t count = std::min(spatial_node_capacity, items.size() - first);
+         IndexBox box = box_of(items[first]);
+         for (std::size_t i = first + 1; i < first + count; i++)
+         {
+            const IndexBox &child = box_of(items[i]);
+            box = IndexBox{std::min(box.xmin, child.xmin), std::min(box.ymin, child.ymin), std::max(box.xmax, child.xmax), std::max(box.ymax, child.ymax)};
+         }
+         parents.push_back(Node{box, first, count});
+      }
+   }
+
+   /**
+    * \brief bulk load an r-tree
+    *
+    * \param entries boxes and ids to index
+    */
+   SpatialIndex::SpatialIndex(std::vector<Entry> entries)
+      : _entries(std::move(entries))
+   {
+      if (this->_entries.empty())
+      {
+         return;
+      }
+      this->_levels.emplace_back();
+      pack_level(this->_entries, this->_levels.back());
+      while (this->_levels.back().size() > 1)
+      {
+         std::vector<Node> parents;
+         pack_level(this->_levels.back(), parents);
+         this->_levels.push_back(std::move(parents));
+      }
+   }
+
+   /**
+    * \brief find the entries whose box overlaps a box
+    *
+    * \param box the query box
+    * \param ids receives the ids of the entries found, in no particular order
+    */
+   void SpatialIndex::query(const IndexBox &box, std::vector<std::uint64_t> &ids) const
+   {
+      if (this->_levels.empty())
+      {
+         return;
+      }
+      /* pending (level, node) pairs, at most capacity per level are pending at once */
+      std::vector<std::pair<std::size_t, std::size_t>> pending;
+      pending.reserve(this->_levels.size() * spatial_node_capacity);
+      pending.emplace_back(this->_levels.size() - 1, 0);
+      while (!pending.empty())
+      {
+         std::size_t level = pending.back().first;
+         const Node &node = this->_levels[level][pending.back().second];
+         pending.pop_back();
+         if (!node.box.overlaps(box))
+         {
+            continue;
+         }
+         for (std::size_t i = node.first; i < node.first + node.count; i++)
+         {
+            if (level == 0)
+            {
+               if (this->_entries[i].box.overlaps(box))
+               {
+                  ids.push_back(this->_entries[i].id);
+               }
+            }
+            else
+            {
+               pending.emplace_back(level - 1, i);
+            }
+         }
+      }
+   }
+
+   /**
+    * \brief split the items of a quadtree cell into quadrants around the
+    *        centre of their bounds, until each holds at most capacity items.
+    *        Splitting around the items rather than the cell keeps a few far
+    *        outliers from leaving the rest in one cell.
+    *
+    * \param first, last the items in the cell
+    * \param depth number of splits above the cell
+    * \param tiles receives the end of each tile, as an offset from begin
+    */
+   static void split_cell(std::vector<TileItem>::iterator first, std::vector<TileItem>::iterator last, std::size_t capacity,
+                          unsigned depth, std::vector<std::size_t> &tiles, std::vector<TileItem>::iterator begin)
+   {
+      double xmin = first->x;
+      double ymin = first->y;
+      double xmax = first->x;
+      double ymax = first->y;
+      for (std::vector<TileItem>::iterator item = first; item != last; ++item)
+      {
+         xmin = std::min(xmin, item->x);
+         ymin = std::min(ymin, item->y);
+         xmax = std::max(xmax, item->x);
+         ymax = std::max(ymax, item->y);
+      }
+      double xmid = xmin + (xmax - xmin) / 2;
+      double ymid = ymin + (ymax - ymin) / 2;
+      /* full enough, too deep, or every item at one point */
+      if (static_cast<std::size_t>(last - first) <= capacity || depth == quadtree_max_depth || !(xmin < xmax || ymin < ymax))
+      {
+         tiles.push_back(static_cast<std::size_t>(last - begin));
+         return;
+      }
+      /* quadrants in z order, items on a split line go to the upper or right quadrant */
+      std::vector<TileItem>::iterator top = std::partition(first, last, [ymid](const TileItem &item) { return item.y < ymid; });
+      std::vector<TileItem>::iterator bottom_right = std::partition(first, top, [xmid](const TileItem &item) { return item.x < xmid; });
+      std::vector<TileItem>::iterator top_right = std::partition(top, last, [xmid](const TileItem &item) { return item.x < xmid; });
+      std::vector<TileItem>::iterator bounds[5] = {first, bottom_right, top, top_right, last};
+      for (int i = 0; i < 4; i++)
+      {
+         if (bounds[i] != bounds[i + 1])
+         {
+            split_cell(bounds[i], bounds[i + 1], capacity, depth + 1, tiles, begin);
+         }
+      }
+   }
+
+   /**
+    * \brief split items into the leaf cells of a quadtree over their points,
+    *        splitting any cell with more than capacity items into quadrants.
+    *        Leaves are listed in z order, so nearby tiles are near in the list.
+    *
+    * \param items the items to split, reordered so each tile is a consecutive run
+    * \param capacity most items in a tile, unless they are too close to split
+    * \param tiles receives the end of each tile's run in items, in order
+    */
+   void quadtree_tiles(std::vector<TileItem> &items, std::size_t capacity, std::vector<std::size_t> &tiles)
+   {
+      tiles.clear();
+      if (!items.empty())
+      {
+         split_cell(items.begin(), items.end(), std::max<std::size_t>(capacity, 1), 0, tiles, items.begin());
+      }
+   }
+};
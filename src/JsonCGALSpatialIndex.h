@@ -0,0 +1,92 @@
+/**
+ * \file JsonCGALSpatialIndex.h
+ * \author Graham Riches (graham.riches@live.com)
+ * \brief bulk loaded r-tree over the bounding boxes of stored objects, and
+ *        the quadtree used to split objects into file tiles
+ * \version 0.1
+ * \date 2026-10-17
+ *
+ * \copyright Copyright (c) 2020
+ *
+ */
+
+#ifndef __JSON_CGAL_SPATIAL_INDEX_H
+#define __JSON_CGAL_SPATIAL_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace JsonCGAL
+{
+   /* children per r-tree node */
+   static const std::size_t spatial_node_capacity = 16;
+
+   /* deepest quadtree split, tiles at this depth are not split further however full */
+   static const unsigned quadtree_max_depth = 24;
+
+   /**
+    * \brief single precision box, rounded outwards from the double box it
+    *        was made from so it always contains it
+    */
+   struct IndexBox
+   {
+      float xmin;
+      float ymin;
+      float xmax;
+      float ymax;
+
+      bool overlaps(const IndexBox &other) const
+      {
+         return this->xmin <= other.xmax && other.xmin <= this->xmax && this->ymin <= other.ymax && other.ymin <= this->ymax;
+      }
+   };
+
+   IndexBox index_box(double xmin, double ymin, double xmax, double ymax);
+
+   /**
+    * \brief read only r-tree, packed bottom up with sort tile recursive (STR)
+    *        loading. Nodes are full except the last of each level, so the
+    *        tree has the least possible nodes and height. Queries return the
+    *        ids of entries whose box overlaps the query box.
+    */
+   class SpatialIndex
+   {
+      public:
+         struct Entry
+         {
+            IndexBox box;
+            std::uint64_t id;
+         };
+
+         explicit SpatialIndex(std::vector<Entry> entries);
+
+         void query(const IndexBox &box, std::vector<std::uint64_t> &ids) const;
+         std::size_t size() const { return this->_entries.size(); }
+
+      private:
+         /* node covering children [first, first + count) of the level below */
+         struct Node
+         {
+            IndexBox box;
+            std::size_t first;
+            std::size_t count;
+         };
+
+         std::vector<Entry> _entries;
+         /* nodes of each level, bottom up. Level 0 nodes hold entries and the last level is the root */
+         std::vector<std::vector<Node>> _levels;
+   };
+
+   /* object placed in a quadtree tile by a point of its extent */
+   struct TileItem
+   {
+      double x;
+      double y;
+      std::uint64_t id;
+   };
+
+   void quadtree_tiles(std::vector<TileItem> &items, std::size_t capacity, std::vector<std::size_t> &tiles);
+};
+
+#endif /* __JSON_CGAL_SPATIAL_INDEX_H */
@@ -0,0 +1,98 @@
+/**
+ * \file JsonCGALStreams.h
+ * \author Graham Riches (graham.riches@live.com)
+ * \brief stream buffer adapters used by the json CGAL readers and writers
+ * \version 0.1
+ * \date 2026-10-17
+ *
+ * \copyright Copyright (c) 2020
+ *
+ */
+
+#ifndef __JSON_CGAL_STREAMS_H
+#define __JSON_CGAL_STREAMS_H
+
+#include <cstddef>
+#include <ios>
+#include <streambuf>
+
+namespace JsonCGAL
+{
+   /**
+    * \brief read only, seekable stream buffer over an existing block of
+    *        memory. The memory is not copied and must outlive the buffer.
+    */
+   class MemoryStreamBuffer : public std::streambuf
+   {
+      public:
+         MemoryStreamBuffer(const char *data, std::size_t size)
+         {
+            char *begin = const_cast<char *>(data);
+            this->setg(begin, begin, begin + size);
+         }
+
+      protected:
+         pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode which) override
+         {
+            off_type origin = (direction == std::ios_base::beg) ? 0 : (direction == std::ios_base::cur) ? this->gptr() - this->eback() : this->egptr() - this->eback();
+            off_type position = origin + offset;
+            if (!(which & std::ios_base::in) || position < 0 || position > this->egptr() - this->eback())
+            {
+               return pos_type(off_type(-1));
+            }
+            this->setg(this->eback(), this->eback() + position, this->egptr());
+            return pos_type(position);
+         }
+
+         pos_type seekpos(pos_type position, std::ios_base::openmode which) override
+         {
+            return this->seekoff(off_type(position), std::ios_base::beg, which);
+         }
+   };
+
+   /**
+    * \brief read only stream buffer presenting a slice of a json array as a
+    *        complete array, i.e. "[" + slice + "]", without copying the slice
+    */
+   class ArraySliceStreamBuffer : public std::streambuf
+   {
+      public:
+         ArraySliceStreamBuffer(const char *data, std::size_t size)
+            : _data(data), _size(size)
+         {
+            char *bracket = const_cast<char *>(&open_bracket);
+            this->setg(bracket, bracket, bracket + 1);
+         }
+
+      protected:
+         int_type underflow() override
+         {
+            char *next;
+            std::size_t length;
+            switch (this->_segment++)
+            {
+            case 0:
+               next = const_cast<char *>(this->_data);
+               length = this->_size;
+               break;
+            case 1:
+               next = const_cast<char *>(&close_bracket);
+               length = 1;
+               break;
+            default:
+               return traits_type::eof();
+            }
+            this->setg(next, next, next + length);
+            return (length > 0) ? traits_type::to_int_type(*next) : this->underflow();
+         }
+
+      private:
+         static constexpr char open_bracket = '[';
+         static constexpr char close_bracket = ']';
+         const char *_data;
+         std::size_t _size;
+         int _segment = 0;
+   };
+};
+
+#endif /* __JSON_CGAL_STREAMS_H */
@@ -10,84 +10,39 @@
  */
 
 #include "JsonCGALTypes.h"
+#include "JsonCGALWriter.h"
 #include <string>
 
 namespace JsonCGAL
 {
-   JsonCGALBase *JsonCGALBase::object_factory(nlohmann::json container)
-   {
-      std::vector<double> coordinates;
-      CGAL_list<Point_2d> points;
-      std::string datatype;
-      nlohmann::json point;
-      nlohmann::json points_container;
-      datatype = container["type"].get<std::string>();
-
-      switch (key_map[datatype])
-      {
-      case SupportedTypes::point_2:
-         coordinates = container["coordinates"].get<std::vector<double>>();
-         return new Point_2d(coordinates[0], coordinates[1]);
-
-      case SupportedTypes::segment_2:
-         points_container = container["points"];
-         for (nlohmann::json::iterator j = points_container.begin(); j < points_container.end(); j++)
-         {
-            point = *j;
-            coordinates = point["coordinates"].get<std::vector<double>>();
-            points.push_back(Point_2d(coordinates[0], coordinates[1]));
-         }
-         return new Segment_2d(points[0], points[1]);
-
-      case SupportedTypes::line_2:
-         points_container = container["points"];
-         for (nlohmann::json::iterator j = points_container.begin(); j < points_container.end(); j++)
-         {
-            point = *j;
-            coordinates = point["coordinates"].get<std::vector<double>>();
-            points.push_back(Point_2d(coordinates[0], coordinates[1]));
-         }
-         return new Line_2d(points[0], points[1]);
-
-      default:
-         std::cerr << "JsonCGAL Error: invalid object type specifier" << std::endl;
-         return new Point_2d;
-      }
-   }
-
    /**
 	 * \brief json encoding method for Point class
 	 * 
 	 * \return nlohmann::json 
 	 */
-	nlohmann::json Point_2d::encode()
+	template <class K>
+	nlohmann::json Basic_point_2<K>::encode()
 	{
 		nlohmann::json json;
-		json = { {"type", this->obj_type}, {"coordinates", {this->x(), this->y()} } };
+		json = { {"type", type_key(type_tag)}, {"coordinates", {CGAL::to_double(this->x()), CGAL::to_double(this->y())} } };
 		return json;
 	}
 
-   Point_2d Point_2d::decode_factory(nlohmann::json container)
-   {
-      std::vector<double> coordinates;
-      coordinates = container["coordinates"].get<std::vector<double>>();
-      return Point_2d(coordinates[0], coordinates[1]);
-   }
-
    /**
 	 * \brief json encoding method for Line class
 	 * 
 	 * \return nlohmann::json 
 	 */
-	nlohmann::json Line_2d::encode()
+	template <class K>
+	nlohmann::json Basic_line_2<K>::encode()
 	{
 		nlohmann::json json;
-		Kernel::Point_2 point;
+		typename K::Point_2 point;
 		point = this->point(0);
-		Point_2d source(point.x(), point.y());
+		Basic_point_2<K> source(point.x(), point.y());
 		point = this->point(1);
-		Point_2d target(point.x(), point.y());
-		json = { {"type", this->obj_type}, {"points", {source.encode(), target.encode()} } };
+		Basic_point_2<K> target(point.x(), point.y());
+		json = { {"type", type_key(type_tag)}, {"points", {source.encode(), target.encode()} } };
 		return json;
 	}
 
@@ -96,15 +51,16 @@ namespace JsonCGAL
 	 * 
 	 * \return nlohmann::json 
 	 */
-	nlohmann::json Segment_2d::encode()
+	template <class K>
+	nlohmann::json Basic_segment_2<K>::encode()
 	{
 		nlohmann::json json;
-		Kernel::Point_2 point;
+		typename K::Point_2 point;
 		point = this->source();
-		Point_2d source(point.x(), point.y());
+		Basic_point_2<K> source(point.x(), point.y());
 		point = this->target();
-		Point_2d target(point.x(), point.y());
-		json = { {"type", this->obj_type}, {"points", {source.encode(), target.encode()} } };
+		Basic_point_2<K> target(point.x(), point.y());
+		json = { {"type", type_key(type_tag)}, {"points", {source.encode(), target.encode()} } };
 		return json;
 	}
 
@@ -113,45 +69,353 @@ namespace JsonCGAL
 	 * 
 	 * \retval nlohmann::json 
 	 */
-	nlohmann::json Weighted_point_2d::encode()
+	template <class K>
+	nlohmann::json Basic_weighted_point_2<K>::encode()
 	{
       nlohmann::json json;
       return json;
 	}
 
-	nlohmann::json Vector_2d::encode()
+	template <class K>
+	nlohmann::json Basic_vector_2<K>::encode()
 	{
       nlohmann::json json;
       return json;
 	}
 
-	nlohmann::json Direction_2d::encode()
+	template <class K>
+	nlohmann::json Basic_direction_2<K>::encode()
 	{
       nlohmann::json json;
       return json;
 	}
 
-	nlohmann::json Ray_2d::encode()
+	template <class K>
+	nlohmann::json Basic_ray_2<K>::encode()
 	{
       nlohmann::json json;
       return json;
 	}
 
-	nlohmann::json Triangle_2d::encode()
+	template <class K>
+	nlohmann::json Basic_triangle_2<K>::encode()
 	{
       nlohmann::json json;
       return json;
 	}
 
-	nlohmann::json Iso_rectangle_2d::encode()
+	template <class K>
+	nlohmann::json Basic_iso_rectangle_2<K>::encode()
 	{
       nlohmann::json json;
       return json;
 	}
 
-	nlohmann::json Circle_2d::encode()
+	template <class K>
+	nlohmann::json Basic_circle_2<K>::encode()
 	{
       nlohmann::json json;
       return json;
 	}
+
+   /**
+    * \brief a coordinate of kernel K as the number type it is written as
+    */
+   template <class K, class FT>
+   static typename coordinate_number<K>::type json_number(const FT &value)
+   {
+      return static_cast<typename coordinate_number<K>::type>(CGAL::to_double(value));
+   }
+
+   /**
+    * \brief write a point in the nested schema used inside points arrays
+    */
+   template <class K>
+   static void write_point(JsonWriter &writer, const typename K::Point_2 &point)
+   {
+      writer.begin_object();
+      writer.key("coordinates");
+      writer.begin_array();
+      writer.value(json_number<K>(point.x()));
+      writer.value(json_number<K>(point.y()));
+      writer.end_array();
+      writer.key("type");
+      writer.value(type_key(SupportedTypes::point_2));
+      writer.end_object();
+   }
+
+   /*
+    * direct json writers, these produce the same schema as encode() without
+    * building a json object. Types encode() has no schema for are written compact
+    */
+   template <class K>
+   void Basic_point_2<K>::write(JsonWriter &writer) const
+   {
+      writer.begin_object();
+      writer.key("coordinates");
+      writer.begin_array();
+      writer.value(json_number<K>(this->x()));
+      writer.value(json_number<K>(this->y()));
+      writer.end_array();
+      writer.key("type");
+      writer.value(type_key(type_tag));
+      writer.end_object();
+   }
+
+   template <class K>
+   void Basic_line_2<K>::write(JsonWriter &writer) const
+   {
+      writer.begin_object();
+      writer.key("points");
+      writer.begin_array();
+      write_point<K>(writer, this->point(0));
+      write_point<K>(writer, this->point(1));
+      writer.end_array();
+      writer.key("type");
+      writer.value(type_key(type_tag));
+      writer.end_object();
+   }
+
+   template <class K>
+   void Basic_segment_2<K>::write(JsonWriter &writer) const
+   {
+      writer.begin_object();
+      writer.key("points");
+      writer.begin_array();
+      write_point<K>(writer, this->source());
+      write_point<K>(writer, this->target());
+      writer.end_array();
+      writer.key("type");
+      writer.value(type_key(type_tag));
+      writer.end_object();
+   }
+
+   /**
+    * \brief write an object with no nested encoding as a compact schema element,
+    *        its type key and flat coordinate layout, e.g. ["circle_2", [0.0, 0.0, 4.0, 1.0]].
+    *        Load reads compact elements mixed into a nested array.
+    */
+   template <class K, class T>
+   static void write_flat(JsonWriter &writer, const T &object)
+   {
+      double values[T::coordinate_count];
+      object.flatten(values);
+      writer.begin_array(true);
+      writer.value(type_key(T::type_tag));
+      writer.begin_array();
+      for (std::size_t i = 0; i < T::coordinate_count; i++)
+      {
+         writer.value(json_number<K>(values[i]));
+      }
+      writer.end_array();
+      writer.end_array();
+   }
+
+   template <class K>
+   void Basic_weighted_point_2<K>::write(JsonWriter &writer) const
+   {
+      write_flat<K>(writer, *this);
+   }
+
+   template <class K>
+   void Basic_vector_2<K>::write(JsonWriter &writer) const
+   {
+      write_flat<K>(writer, *this);
+   }
+
+   template <class K>
+   void Basic_direction_2<K>::write(JsonWriter &writer) const
+   {
+      write_flat<K>(writer, *this);
+   }
+
+   template <class K>
+   void Basic_ray_2<K>::write(JsonWriter &writer) const
+   {
+      write_flat<K>(writer, *this);
+   }
+
+   template <class K>
+   void Basic_triangle_2<K>::write(JsonWriter &writer) const
+   {
+      write_flat<K>(writer, *this);
+   }
+
+   template <class K>
+   void Basic_iso_rectangle_2<K>::write(JsonWriter &writer) const
+   {
+      write_flat<K>(writer, *this);
+   }
+
+   template <class K>
+   void Basic_circle_2<K>::write(JsonWriter &writer) const
+   {
+      write_flat<K>(writer, *this);
+   }
+
+   /*
+    * flat coordinate layout of each type, shared by the binary format. Every
+    * value needed to rebuild the object exactly is stored, e.g. lines keep
+    * their a, b, c coefficients rather than two derived points.
+    */
+   template <class K>
+   void Basic_point_2<K>::flatten(double *coordinates) const
+   {
+      coordinates[0] = CGAL::to_double(this->x());
+      coordinates[1] = CGAL::to_double(this->y());
+   }
+
+   template <class K>
+   Basic_point_2<K> Basic_point_2<K>::unflatten(const double *coordinates)
+   {
+      return Basic_point_2(coordinates[0], coordinates[1]);
+   }
+
+   template <class K>
+   void Basic_line_2<K>::flatten(double *coordinates) const
+   {
+      coordinates[0] = CGAL::to_double(this->a());
+      coordinates[1] = CGAL::to_double(this->b());
+      coordinates[2] = CGAL::to_double(this->c());
+   }
+
+   template <class K>
+   Basic_line_2<K> Basic_line_2<K>::unflatten(const double *coordinates)
+   {
+      return Basic_line_2(coordinates[0], coordinates[1], coordinates[2]);
+   }
+
+   template <class K>
+   void Basic_segment_2<K>::flatten(double *coordinates) const
+   {
+      coordinates[0] = CGAL::to_double(this->source().x());
+      coordinates[1] = CGAL::to_double(this->source().y());
+      coordinates[2] = CGAL::to_double(this->target().x());
+      coordinates[3] = CGAL::to_double(this->target().y());
+   }
+
+   template <class K>
+   Basic_segment_2<K> Basic_segment_2<K>::unflatten(const double *coordinates)
+   {
+      return Basic_segment_2(typename K::Point_2(coordinates[0], coordinates[1]), typename K::Point_2(coordinates[2], coordinates[3]));
+   }
+
+   template <class K>
+   void Basic_weighted_point_2<K>::flatten(double *coordinates) const
+   {
+      coordinates[0] = CGAL::to_double(this->point().x());
+      coordinates[1] = CGAL::to_double(this->point().y());
+      coordinates[2] = CGAL::to_double(this->weight());
+   }
+
+   template <class K>
+   Basic_weighted_point_2<K> Basic_weighted_point_2<K>::unflatten(const double *coordinates)
+   {
+      return Basic_weighted_point_2(typename K::Point_2(coordinates[0], coordinates[1]), coordinates[2]);
+   }
+
+   template <class K>
+   void Basic_vector_2<K>::flatten(double *coordinates) const
+   {
+      coordinates[0] = CGAL::to_double(this->x());
+      coordinates[1] = CGAL::to_double(this->y());
+   }
+
+   template <class K>
+   Basic_vector_2<K> Basic_vector_2<K>::unflatten(const double *coordinates)
+   {
+      return Basic_vector_2(coordinates[0], coordinates[1]);
+   }
+
+   template <class K>
+   void Basic_direction_2<K>::flatten(double *coordinates) const
+   {
+      coordinates[0] = CGAL::to_double(this->dx());
+      coordinates[1] = CGAL::to_double(this->dy());
+   }
+
+   template <class K>
+   Basic_direction_2<K> Basic_direction_2<K>::unflatten(const double *coordinates)
+   {
+      return Basic_direction_2(coordinates[0], coordinates[1]);
+   }
+
+   template <class K>
+   void Basic_ray_2<K>::flatten(double *coordinates) const
+   {
+      coordinates[0] = CGAL::to_double(this->source().x());
+      coordinates[1] = CGAL::to_double(this->source().y());
+      coordinates[2] = CGAL::to_double(this->second_point().x());
+      coordinates[3] = CGAL::to_double(this->second_point().y());
+   }
+
+   template <class K>
+   Basic_ray_2<K> Basic_ray_2<K>::unflatten(const double *coordinates)
+   {
+      return Basic_ray_2(typename K::Point_2(coordinates[0], coordinates[1]), typename K::Point_2(coordinates[2], coordinates[3]));
+   }
+
+   template <class K>
+   void Basic_triangle_2<K>::flatten(double *coordinates) const
+   {
+      for (int i = 0; i < 3; i++)
+      {
+         coordinates[2 * i] = CGAL::to_double(this->vertex(i).x());
+         coordinates[2 * i + 1] = CGAL::to_double(this->vertex(i).y());
+      }
+   }
+
+   template <class K>
+   Basic_triangle_2<K> Basic_triangle_2<K>::unflatten(const double *coordinates)
+   {
+      return Basic_triangle_2(typename K::Point_2(coordinates[0], coordinates[1]),
+                         typename K::Point_2(coordinates[2], coordinates[3]),
+                         typename K::Point_2(coordinates[4], coordinates[5]));
+   }
+
+   template <class K>
+   void Basic_iso_rectangle_2<K>::flatten(double *coordinates) const
+   {
+      coordinates[0] = CGAL::to_double(this->xmin());
+      coordinates[1] = CGAL::to_double(this->ymin());
+      coordinates[2] = CGAL::to_double(this->xmax());
+      coordinates[3] = CGAL::to_double(this->ymax());
+   }
+
+   template <class K>
+   Basic_iso_rectangle_2<K> Basic_iso_rectangle_2<K>::unflatten(const double *coordinates)
+   {
+      return Basic_iso_rectangle_2(typename K::Point_2(coordinates[0], coordinates[1]), typename K::Point_2(coordinates[2], coordinates[3]));
+   }
+
+   template <class K>
+   void Basic_circle_2<K>::flatten(double *coordinates) const
+   {
+      coordinates[0] = CGAL::to_double(this->center().x());
+      coordinates[1] = CGAL::to_double(this->center().y());
+      coordinates[2] = CGAL::to_double(this->squared_radius());
+      coordinates[3] = (this->orientation() == CGAL::CLOCKWISE) ? -1.0 : 1.0;
+   }
+
+   template <class K>
+   Basic_circle_2<K> Basic_circle_2<K>::unflatten(const double *coordinates)
+   {
+      CGAL::Orientation orientation = (coordinates[3] < 0) ? CGAL::CLOCKWISE : CGAL::COUNTERCLOCKWISE;
+      return Basic_circle_2(typename K::Point_2(coordinates[0], coordinates[1]), coordinates[2], orientation);
+   }
+
+   /* wrappers for the kernels listed in cgal_kernel_config.h */
+#define JSON_CGAL_INSTANTIATE_WRAPPERS(K) \
+   template class Basic_point_2<K>;        \
+   template class Basic_line_2<K>;         \
+   template class Basic_segment_2<K>;      \
+   template class Basic_weighted_point_2<K>; \
+   template class Basic_vector_2<K>;       \
+   template class Basic_direction_2<K>;    \
+   template class Basic_ray_2<K>;          \
+   template class Basic_triangle_2<K>;     \
+   template class Basic_iso_rectangle_2<K>; \
+   template class Basic_circle_2<K>;
+   JSON_CGAL_FOR_EACH_KERNEL(JSON_CGAL_INSTANTIATE_WRAPPERS)
+#undef JSON_CGAL_INSTANTIATE_WRAPPERS
 };
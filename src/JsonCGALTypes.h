@@ -12,122 +12,241 @@
 #ifndef __JSON_CGAL_TYPES_H
 #define __JSON_CGAL_TYPES_H
 
+#include <cstddef>
+#include <type_traits>
+
 #include "JsonCGALMap.h"
 #include "cgal_kernel_config.h"
 #include "json.hpp"
 
 namespace JsonCGAL
 {
+   class JsonWriter;
+
    /**
-    * \brief parent class for JSON wrapper for CGAL type classes
+    * \brief number type coordinates of kernel K are written as. Single
+    *        precision kernels write floats, so json output holds the shortest
+    *        float representation and binary output four byte values.
+    */
+   template <class K>
+   struct coordinate_number
+   {
+      typedef typename std::conditional<std::is_same<typename K::FT, float>::value, float, double>::type type;
+   };
+
+   /*
+    * wrappers for the objects of kernel K. Each one derives only from the
+    * kernel's own type, so it has the same size and layout, and converts
+    * implicitly from it. The type of a wrapper is the static type_tag, there
+    * is no virtual base. The Point_2d family of typedefs below names the
+    * wrappers of the default Kernel.
     */
-   class JsonCGALBase
+   template <class K>
+   class Basic_point_2 : public K::Point_2
+   {
+      public:
+         typedef typename K::Point_2 kernel_type;
+         static constexpr SupportedTypes::SupportedTypes type_tag = SupportedTypes::point_2;
+         using K::Point_2::Point_2;
+         Basic_point_2(const typename K::Point_2 &point) : K::Point_2(point) {}
+         nlohmann::json encode();
+         void write(JsonWriter &writer) const;
+         static const std::size_t coordinate_count = 2;
+         void flatten(double *coordinates) const;
+         static Basic_point_2 unflatten(const double *coordinates);
+         enum SupportedTypes::SupportedTypes getType() { return type_tag; }
+   };
+
+   template <class K>
+   class Basic_line_2 : public K::Line_2
+   {
+      public:
+         typedef typename K::Line_2 kernel_type;
+         static constexpr SupportedTypes::SupportedTypes type_tag = SupportedTypes::line_2;
+         using K::Line_2::Line_2;
+         Basic_line_2(const typename K::Line_2 &line) : K::Line_2(line) {}
+         nlohmann::json encode();
+         void write(JsonWriter &writer) const;
+         static const std::size_t coordinate_count = 3;
+         void flatten(double *coordinates) const;
+         static Basic_line_2 unflatten(const double *coordinates);
+         enum SupportedTypes::SupportedTypes getType() { return type_tag; }
+   };
+
+   template <class K>
+   class Basic_segment_2 : public K::Segment_2
+   {
+      public:
+         typedef typename K::Segment_2 kernel_type;
+         static constexpr SupportedTypes::SupportedTypes type_tag = SupportedTypes::segment_2;
+         using K::Segment_2::Segment_2;
+         Basic_segment_2(const typename K::Segment_2 &segment) : K::Segment_2(segment) {}
+         nlohmann::json encode();
+         void write(JsonWriter &writer) const;
+         static const std::size_t coordinate_count = 4;
+         void flatten(double *coordinates) const;
+         static Basic_segment_2 unflatten(const double *coordinates);
+         enum SupportedTypes::SupportedTypes getType() { return type_tag; }
+   };
+
+   template <class K>
+   class Basic_weighted_point_2 : public K::Weighted_point_2
+   {
+      public:
+         typedef typename K::Weighted_point_2 kernel_type;
+         static constexpr SupportedTypes::SupportedTypes type_tag = SupportedTypes::weighted_point_2;
+         using K::Weighted_point_2::Weighted_point_2;
+         Basic_weighted_point_2(const typename K::Weighted_point_2 &point) : K::Weighted_point_2(point) {}
+         nlohmann::json encode();
+         void write(JsonWriter &writer) const;
+         static const std::size_t coordinate_count = 3;
+         void flatten(double *coordinates) const;
+         static Basic_weighted_point_2 unflatten(const double *coordinates);
+         enum SupportedTypes::SupportedTypes getType() { return type_tag; }
+   };
+
+   template <class K>
+   class Basic_vector_2 : public K::Vector_2
    {
       public:
-         static JsonCGALBase *object_factory(nlohmann::json container);
-         virtual nlohmann::json encode() = 0;
-         virtual enum SupportedTypes::SupportedTypes getType() = 0;
+         typedef typename K::Vector_2 kernel_type;
+         static constexpr SupportedTypes::SupportedTypes type_tag = SupportedTypes::vector_2;
+         using K::Vector_2::Vector_2;
+         Basic_vector_2(const typename K::Vector_2 &vector) : K::Vector_2(vector) {}
+         nlohmann::json encode();
+         void write(JsonWriter &writer) const;
+         static const std::size_t coordinate_count = 2;
+         void flatten(double *coordinates) const;
+         static Basic_vector_2 unflatten(const double *coordinates);
+         enum SupportedTypes::SupportedTypes getType() { return type_tag; }
    };
 
-   class Point_2d : public Kernel::Point_2, public JsonCGALBase
-	{
-      private:
-         std::string obj_type = "point_2";
-		public:
-			using Kernel::Point_2::Point_2;
-         Point_2d decode_factory(nlohmann::json container);
-			nlohmann::json encode();
-			enum SupportedTypes::SupportedTypes getType() { return key_map[this->obj_type]; }
-	};
-
-   class Line_2d : public Kernel::Line_2, public JsonCGALBase
-	{
-      private:
-         std::string obj_type = "line_2";
-		public:
-			using Kernel::Line_2::Line_2;
-			nlohmann::json encode();
-         enum SupportedTypes::SupportedTypes getType() { return key_map[this->obj_type]; }
-	};
-
-   class Segment_2d : public Kernel::Segment_2, public JsonCGALBase
-	{
-      private:
-         std::string obj_type = "segment_2";
-		public:
-			using Kernel::Segment_2::Segment_2;
-			nlohmann::json encode();
-			enum SupportedTypes::SupportedTypes getType() { return key_map[this->obj_type]; }
-	};
-
-   class Weighted_point_2d : public Kernel::Weighted_point_2, public JsonCGALBase
+   template <class K>
+   class Basic_direction_2 : public K::Direction_2
    {
-      private:
-         std::string obj_type = "weighted_point_2";
-	   public:
-		   using Kernel::Weighted_point_2::Weighted_point_2;
-		   nlohmann::json encode();
-         enum SupportedTypes::SupportedTypes getType() { return key_map[this->obj_type]; }
+      public:
+         typedef typename K::Direction_2 kernel_type;
+         static constexpr SupportedTypes::SupportedTypes type_tag = SupportedTypes::direction_2;
+         using K::Direction_2::Direction_2;
+         Basic_direction_2(const typename K::Direction_2 &direction) : K::Direction_2(direction) {}
+         nlohmann::json encode();
+         void write(JsonWriter &writer) const;
+         static const std::size_t coordinate_count = 2;
+         void flatten(double *coordinates) const;
+         static Basic_direction_2 unflatten(const double *coordinates);
+         enum SupportedTypes::SupportedTypes getType() { return type_tag; }
    };
 
-   class Vector_2d : public Kernel::Vector_2, public JsonCGALBase
+   template <class K>
+   class Basic_ray_2 : public K::Ray_2
    {
-      private:
-         std::string obj_type = "vector_2";
-	   public:
-		   using Kernel::Vector_2::Vector_2;
-		   nlohmann::json encode();
-         enum SupportedTypes::SupportedTypes getType() { return key_map[this->obj_type]; }
+      public:
+         typedef typename K::Ray_2 kernel_type;
+         static constexpr SupportedTypes::SupportedTypes type_tag = SupportedTypes::ray_2;
+         using K::Ray_2::Ray_2;
+         Basic_ray_2(const typename K::Ray_2 &ray) : K::Ray_2(ray) {}
+         nlohmann::json encode();
+         void write(JsonWriter &writer) const;
+         static const std::size_t coordinate_count = 4;
+         void flatten(double *coordinates) const;
+         static Basic_ray_2 unflatten(const double *coordinates);
+         enum SupportedTypes::SupportedTypes getType() { return type_tag; }
    };
 
-   class Direction_2d : public Kernel::Direction_2, public JsonCGALBase
+   template <class K>
+   class Basic_triangle_2 : public K::Triangle_2
    {
-      private:
-         std::string obj_type = "direction_2";
-	   public:
-		   using Kernel::Direction_2::Direction_2;
-		   nlohmann::json encode();
-         enum SupportedTypes::SupportedTypes getType() { return key_map[this->obj_type]; }
+      public:
+         typedef typename K::Triangle_2 kernel_type;
+         static constexpr SupportedTypes::SupportedTypes type_tag = SupportedTypes::triangle_2;
+         using K::Triangle_2::Triangle_2;
+         Basic_triangle_2(const typename K::Triangle_2 &triangle) : K::Triangle_2(triangle) {}
+         nlohmann::json encode();
+         void write(JsonWriter &writer) const;
+         static const std::size_t coordinate_count = 6;
+         void flatten(double *coordinates) const;
+         static Basic_triangle_2 unflatten(const double *coordinates);
+         enum SupportedTypes::SupportedTypes getType() { return type_tag; }
    };
 
-   class Ray_2d : public Kernel::Ray_2, public JsonCGALBase
+   template <class K>
+   class Basic_iso_rectangle_2 : public K::Iso_rectangle_2
    {
-      private:
-         std::string obj_type = "ray_2";
-	   public:
-		   using Kernel::Ray_2::Ray_2;
-		   nlohmann::json encode();
-         enum SupportedTypes::SupportedTypes getType() { return key_map[this->obj_type]; }
+      public:
+         typedef typename K::Iso_rectangle_2 kernel_type;
+         static constexpr SupportedTypes::SupportedTypes type_tag = SupportedTypes::iso_rectangle_2;
+         using K::Iso_rectangle_2::Iso_rectangle_2;
+         Basic_iso_rectangle_2(const typename K::Iso_rectangle_2 &rectangle) : K::Iso_rectangle_2(rectangle) {}
+         nlohmann::json encode();
+         void write(JsonWriter &writer) const;
+         static const std::size_t coordinate_count = 4;
+         void flatten(double *coordinates) const;
+         static Basic_iso_rectangle_2 unflatten(const double *coordinates);
+         enum SupportedTypes::SupportedTypes getType() { return type_tag; }
    };
 
-   class Triangle_2d : public Kernel::Triangle_2, public JsonCGALBase
+   template <class K>
+   class Basic_circle_2 : public K::Circle_2
    {
-      private:
-         std::string obj_type = "triangle_2";
-		public:
-		   using Kernel::Triangle_2::Triangle_2;
-		   nlohmann::json encode();
-         enum SupportedTypes::SupportedTypes getType() { return key_map[this->obj_type]; }
+      public:
+         typedef typename K::Circle_2 kernel_type;
+         static constexpr SupportedTypes::SupportedTypes type_tag = SupportedTypes::circle_2;
+         using K::Circle_2::Circle_2;
+         Basic_circle_2(const typename K::Circle_2 &circle) : K::Circle_2(circle) {}
+         nlohmann::json encode();
+         void write(JsonWriter &writer) const;
+         static const std::size_t coordinate_count = 4;
+         void flatten(double *coordinates) const;
+         static Basic_circle_2 unflatten(const double *coordinates);
+         enum SupportedTypes::SupportedTypes getType() { return type_tag; }
    };
 
-   class Iso_rectangle_2d : public Kernel::Iso_rectangle_2, public JsonCGALBase
+   typedef Basic_point_2<Kernel> Point_2d;
+   typedef Basic_line_2<Kernel> Line_2d;
+   typedef Basic_segment_2<Kernel> Segment_2d;
+   typedef Basic_weighted_point_2<Kernel> Weighted_point_2d;
+   typedef Basic_vector_2<Kernel> Vector_2d;
+   typedef Basic_direction_2<Kernel> Direction_2d;
+   typedef Basic_ray_2<Kernel> Ray_2d;
+   typedef Basic_triangle_2<Kernel> Triangle_2d;
+   typedef Basic_iso_rectangle_2<Kernel> Iso_rectangle_2d;
+   typedef Basic_circle_2<Kernel> Circle_2d;
+
+   /* first of Wrappers whose kernel_type is T, or T itself when there is none */
+   template <class T, class... Wrappers>
+   struct select_wrapper
    {
-      private:
-         std::string obj_type = "iso_rectangle_2";
-	   public:
-		   using Kernel::Iso_rectangle_2::Iso_rectangle_2;
-		   nlohmann::json encode();
-         enum SupportedTypes::SupportedTypes getType() { return key_map[this->obj_type]; }
+      typedef T type;
    };
 
-   class Circle_2d : public Kernel::Circle_2, public JsonCGALBase
+   template <class T, class W, class... Wrappers>
+   struct select_wrapper<T, W, Wrappers...>
+   {
+      typedef typename std::conditional<std::is_same<T, typename W::kernel_type>::value, W,
+                                        typename select_wrapper<T, Wrappers...>::type>::type type;
+   };
+
+   /**
+    * \brief wrapper type used to store objects of type T in a container of
+    *        kernel K, so plain kernel objects can be added without first
+    *        converting them
+    */
+   template <class T, class K = Kernel>
+   struct wrapper_of
+      : select_wrapper<T, Basic_point_2<K>, Basic_line_2<K>, Basic_segment_2<K>, Basic_weighted_point_2<K>, Basic_vector_2<K>,
+                       Basic_direction_2<K>, Basic_ray_2<K>, Basic_triangle_2<K>, Basic_iso_rectangle_2<K>, Basic_circle_2<K>>
+   {
+   };
+
+   /**
+    * \brief compile time registry of a wrapper type's tag and json key
+    */
+   template <class T>
+   struct type_traits
    {
-      private:
-         std::string obj_type = "circle_2";
-	   public:
-		   using Kernel::Circle_2::Circle_2;
-		   nlohmann::json encode();
-         enum SupportedTypes::SupportedTypes getType() { return key_map[this->obj_type]; }
+      static constexpr SupportedTypes::SupportedTypes type = T::type_tag;
+      static constexpr const char *key = type_key(T::type_tag);
+      static_assert(T::coordinate_count == type_column_counts[T::type_tag], "every flat coordinate needs a column name");
    };
 
 };
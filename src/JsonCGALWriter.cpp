@@ -0,0 +1,191 @@
+/**
+ * \file JsonCGALWriter.cpp
+ * \author Graham Riches (graham.riches@live.com)
+ * \brief streaming json writer that appends directly to an output buffer
+ * \version 0.1
+ * \date 2026-10-17
+ *
+ * \copyright Copyright (c) 2020
+ *
+ */
+
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+#include "JsonCGALWriter.h"
+
+namespace JsonCGAL
+{
+   JsonWriter::JsonWriter(std::string &output, int indent)
+      : _output(output), _indent(indent)
+   {
+   }
+
+   /**
+    * \brief start a new line at the given container depth (pretty mode only)
+    */
+   void JsonWriter::newline(std::size_t depth)
+   {
+      if (this->_indent >= 0)
+      {
+         this->_output.push_back('\n');
+         this->_output.append(depth * static_cast<std::size_t>(this->_indent), ' ');
+      }
+   }
+
+   /**
+    * \brief emit whatever has to precede the next value or key
+    */
+   void JsonWriter::separator()
+   {
+      if (this->_after_key)
+      {
+         this->_after_key = false;
+         return;
+      }
+      if (this->_first.empty())
+      {
+         return;
+      }
+      bool first = this->_first.back();
+      if (!first)
+      {
+         this->_output.push_back(',');
+      }
+      this->_first.back() = false;
+      if (!this->is_inline())
+      {
+         this->newline(this->_first.size());
+      }
+      else if (!first && this->_indent >= 0)
+      {
+         this->_output.push_back(' ');
+      }
+   }
+
+   /**
+    * \brief open an array
+    *
+    * \param inline_elements write the array and everything in it on one line
+    */
+   void JsonWriter::begin_array(bool inline_elements)
+   {
+      this->separator();
+      this->_output.push_back('[');
+      this->_first.push_back(true);
+      if (inline_elements && this->_inline_depth == 0)
+      {
+         this->_inline_depth = this->_first.size();
+      }
+   }
+
+   /**
+    * \brief resume writing the elements of a top level array opened by
+    *        another writer, so separate writers can each encode part of it
+    *
+    * \param first true if no elements have been written to the array yet
+    */
+   void JsonWriter::continue_array(bool first)
+   {
+      this->_first.push_back(first);
+   }
+
+   void JsonWriter::end_array()
+   {
+      bool empty = this->_first.back();
+      bool inline_elements = this->is_inline();
+      if (this->_inline_depth == this->_first.size())
+      {
+         this->_inline_depth = 0;
+      }
+      this->_first.pop_back();
+      if (!empty && !inline_elements)
+      {
+         this->newline(this->_first.size());
+      }
+      this->_output.push_back(']');
+   }
+
+   void JsonWriter::begin_object()
+   {
+      this->separator();
+      this->_output.push_back('{');
+      this->_first.push_back(true);
+   }
+
+   void JsonWriter::end_object()
+   {
+      bool empty = this->_first.back();
+      bool inline_elements = this->is_inline();
+      this->_first.pop_back();
+      if (!empty && !inline_elements)
+      {
+         this->newline(this->_first.size());
+      }
+      this->_output.push_back('}');
+   }
+
+   /**
+    * \brief write an object key. Keys are written as is and must not need escaping.
+    */
+   void JsonWriter::key(const char *name)
+   {
+      this->separator();
+      this->_output.push_back('"');
+      this->_output.append(name);
+      this->_output.append((this->_indent >= 0) ? "\": " : "\":");
+      this->_after_key = true;
+   }
+
+   /**
+    * \brief write a string value. Strings are written as is and must not need escaping.
+    */
+   void JsonWriter::value(const char *text)
+   {
+      this->separator();
+      this->_output.push_back('"');
+      this->_output.append(text);
+      this->_output.push_back('"');
+   }
+
+   void JsonWriter::null()
+   {
+      this->separator();
+      this->_output.append("null");
+   }
+
+   /**
+    * \brief append the shortest round trip text of a floating point number,
+    *        keeping a decimal point or exponent so it still reads as a float.
+    *        Non-finite values have no json representation and become null.
+    */
+   template <class Float>
+   static void append_number(std::string &output, Float number)
+   {
+      char buffer[32];
+      if (!std::isfinite(number))
+      {
+         output.append("null");
+         return;
+      }
+      char *end = std::to_chars(buffer, buffer + sizeof(buffer), number).ptr;
+      output.append(buffer, end);
+      if (std::memchr(buffer, '.', end - buffer) == nullptr && std::memchr(buffer, 'e', end - buffer) == nullptr)
+      {
+         output.append(".0");
+      }
+   }
+
+   void JsonWriter::value(double number)
+   {
+      this->separator();
+      append_number(this->_output, number);
+   }
+
+   void JsonWriter::value(float number)
+   {
+      this->separator();
+      append_number(this->_output, number);
+   }
+};
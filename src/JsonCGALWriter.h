@@ -0,0 +1,60 @@
+/**
+ * \file JsonCGALWriter.h
+ * \author Graham Riches (graham.riches@live.com)
+ * \brief streaming json writer that appends directly to an output buffer
+ * \version 0.1
+ * \date 2026-10-17
+ *
+ * \copyright Copyright (c) 2020
+ *
+ */
+
+#ifndef __JSON_CGAL_WRITER_H
+#define __JSON_CGAL_WRITER_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace JsonCGAL
+{
+   /**
+    * \brief writes json text into a string buffer without building a DOM.
+    *        Numbers use the shortest representation that round trips. A
+    *        negative indent writes compact json with no whitespace.
+    */
+   class JsonWriter
+   {
+      public:
+         explicit JsonWriter(std::string &output, int indent = 4);
+
+         void begin_array(bool inline_elements = false);
+         void continue_array(bool first);
+         void end_array();
+         void begin_object();
+         void end_object();
+         void key(const char *name);
+         void value(double number);
+         void value(float number);
+         void value(const char *text);
+         void null();
+
+         std::string &output() { return this->_output; }
+
+      private:
+         void separator();
+         void newline(std::size_t depth);
+
+         bool is_inline() const { return this->_inline_depth != 0 && this->_first.size() >= this->_inline_depth; }
+
+         std::string &_output;
+         int _indent;
+         /* one entry per open container, true until its first element is written */
+         std::vector<bool> _first;
+         bool _after_key = false;
+         /* depth of the outermost container written on a single line, 0 if none */
+         std::size_t _inline_depth = 0;
+   };
+};
+
+#endif /* __JSON_CGAL_WRITER_H */
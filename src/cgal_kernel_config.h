@@ -12,10 +12,28 @@
 #ifndef __CGAL_KERNEL_CONFIG
 #define __CGAL_KERNEL_CONFIG
 
+#include <vector>
 #include <CGAL/Simple_cartesian.h>
+#include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
 
-/* setup the CGAL kernel */
+/* single precision kernel, stores and writes coordinates as float32. Use it
+   for data with no precision beyond float, e.g. sensor point clouds */
+typedef CGAL::Simple_cartesian<float> Float_kernel;
+
+/* setup the default CGAL kernel, used by JsonCGAL::JsonCGAL and the Point_2d family of wrappers.
+   Define JSON_CGAL_SINGLE_PRECISION to make the single precision kernel the default */
+#ifdef JSON_CGAL_SINGLE_PRECISION
+typedef Float_kernel Kernel;
+#else
 typedef CGAL::Simple_cartesian<double> Kernel;
+#endif
+
+/* kernels the library is built for. BasicJsonCGAL and the wrapper templates
+   work on other kernels once they are added to this list */
+#define JSON_CGAL_FOR_EACH_KERNEL(INSTANTIATE)  \
+   INSTANTIATE(CGAL::Simple_cartesian<double>) \
+   INSTANTIATE(Float_kernel)                   \
+   INSTANTIATE(CGAL::Exact_predicates_inexact_constructions_kernel)
 
 /* create a generic container for holding geometry objects */
 template<typename T>
@@ -0,0 +1,218 @@
+/**
+ * @file JsonBinary-test.cpp
+ * @author Graham Riches (graham.riches@live.com)
+ * @brief unit tests for the binary geometry format
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "JsonCGAL.h"
+#include "JsonCGALBinary.h"
+#include "JsonCGALStreams.h"
+#include "JsonCGALTypes.h"
+#include "cgal_kernel_config.h"
+
+/* path of a scratch file in the test temporary directory */
+static std::string temp_file(const std::string &name)
+{
+	return ::testing::TempDir() + name;
+}
+
+/* fill a container with one object of every supported type */
+static void add_all_types(JsonCGAL::JsonCGAL &json_data)
+{
+	Kernel::Point_2 p(0.1, -2.5);
+	Kernel::Point_2 q(1e-300, 7.25);
+	Kernel::Point_2 r(-3.0 / 7.0, 1e17);
+	json_data.add_objects(CGAL_list<JsonCGAL::Point_2d>{JsonCGAL::Point_2d(0.1, 0.2)});
+	json_data.add_objects(CGAL_list<JsonCGAL::Line_2d>{JsonCGAL::Line_2d(p, q)});
+	json_data.add_objects(CGAL_list<JsonCGAL::Segment_2d>{JsonCGAL::Segment_2d(p, r)});
+	json_data.add_objects(CGAL_list<JsonCGAL::Weighted_point_2d>{JsonCGAL::Weighted_point_2d(p, 0.3)});
+	json_data.add_objects(CGAL_list<JsonCGAL::Vector_2d>{JsonCGAL::Vector_2d(1.5, -0.7)});
+	json_data.add_objects(CGAL_list<JsonCGAL::Direction_2d>{JsonCGAL::Direction_2d(-1, 1.0 / 3.0)});
+	json_data.add_objects(CGAL_list<JsonCGAL::Ray_2d>{JsonCGAL::Ray_2d(q, r)});
+	json_data.add_objects(CGAL_list<JsonCGAL::Triangle_2d>{JsonCGAL::Triangle_2d(p, q, r)});
+	json_data.add_objects(CGAL_list<JsonCGAL::Iso_rectangle_2d>{JsonCGAL::Iso_rectangle_2d(p, r)});
+	json_data.add_objects(CGAL_list<JsonCGAL::Circle_2d>{JsonCGAL::Circle_2d(q, 2.0 / 3.0, CGAL::CLOCKWISE)});
+	json_data.add_objects(CGAL_list<JsonCGAL::Point_2d>{JsonCGAL::Point_2d(5, 6)});
+}
+
+TEST(BinaryTests, TestBinaryRoundTripIsLossless)
+{
+	JsonCGAL::JsonCGAL create_json_data;
+	JsonCGAL::JsonCGAL load_json_data;
+	add_all_types(create_json_data);
+	ASSERT_TRUE(load_json_data.load_from_string(create_json_data.dump_to_string(JsonCGAL::FileFormat::binary)));
+	ASSERT_EQ(load_json_data.size(), create_json_data.size());
+	ASSERT_TRUE(load_json_data.view<JsonCGAL::Point_2d>()[1] == create_json_data.view<JsonCGAL::Point_2d>()[1]);
+	ASSERT_TRUE(load_json_data.view<JsonCGAL::Line_2d>()[0] == create_json_data.view<JsonCGAL::Line_2d>()[0]);
+	ASSERT_TRUE(load_json_data.view<JsonCGAL::Segment_2d>()[0] == create_json_data.view<JsonCGAL::Segment_2d>()[0]);
+	ASSERT_TRUE(load_json_data.view<JsonCGAL::Weighted_point_2d>()[0] == create_json_data.view<JsonCGAL::Weighted_point_2d>()[0]);
+	ASSERT_TRUE(load_json_data.view<JsonCGAL::Vector_2d>()[0] == create_json_data.view<JsonCGAL::Vector_2d>()[0]);
+	ASSERT_TRUE(load_json_data.view<JsonCGAL::Direction_2d>()[0] == create_json_data.view<JsonCGAL::Direction_2d>()[0]);
+	ASSERT_TRUE(load_json_data.view<JsonCGAL::Ray_2d>()[0] == create_json_data.view<JsonCGAL::Ray_2d>()[0]);
+	ASSERT_TRUE(load_json_data.view<JsonCGAL::Triangle_2d>()[0] == create_json_data.view<JsonCGAL::Triangle_2d>()[0]);
+	ASSERT_TRUE(load_json_data.view<JsonCGAL::Iso_rectangle_2d>()[0] == create_json_data.view<JsonCGAL::Iso_rectangle_2d>()[0]);
+	ASSERT_TRUE(load_json_data.view<JsonCGAL::Circle_2d>()[0] == create_json_data.view<JsonCGAL::Circle_2d>()[0]);
+	ASSERT_EQ(load_json_data.dump_to_string(JsonCGAL::FileFormat::binary), create_json_data.dump_to_string(JsonCGAL::FileFormat::binary));
+}
+
+TEST(BinaryTests, TestBinaryFileIsDetectedOnLoad)
+{
+	std::string filename = temp_file("test_dump.jcgb");
+	JsonCGAL::JsonCGAL create_json_data;
+	JsonCGAL::JsonCGAL load_json_data;
+	add_all_types(create_json_data);
+	ASSERT_TRUE(create_json_data.dump(filename, JsonCGAL::FileFormat::binary));
+	ASSERT_TRUE(load_json_data.load(filename));
+	ASSERT_EQ(load_json_data.count<JsonCGAL::Point_2d>(), 2);
+	ASSERT_EQ(load_json_data.count<JsonCGAL::Circle_2d>(), 1);
+	std::remove(filename.c_str());
+}
+
+TEST(BinaryTests, TestTruncatedBinaryIsRejected)
+{
+	JsonCGAL::JsonCGAL create_json_data;
+	JsonCGAL::JsonCGAL load_json_data;
+	add_all_types(create_json_data);
+	std::string binary = create_json_data.dump_to_string(JsonCGAL::FileFormat::binary);
+	ASSERT_FALSE(load_json_data.load_from_string(binary.substr(0, binary.size() - 4)));
+	ASSERT_EQ(load_json_data.size(), 0);
+	ASSERT_EQ(load_json_data.count<JsonCGAL::Point_2d>(), 0);
+}
+
+TEST(BinaryTests, TestSinglePrecisionRoundTrip)
+{
+	typedef JsonCGAL::BasicJsonCGAL<Float_kernel> FloatJsonCGAL;
+	FloatJsonCGAL create_json_data;
+	std::vector<Float_kernel::Point_2> points = {Float_kernel::Point_2(0.1f, -2.5f), Float_kernel::Point_2(1.0f / 3.0f, 7.25f)};
+	create_json_data.add_objects(points.begin(), points.end());
+	ASSERT_EQ(create_json_data.dump_to_string(JsonCGAL::DumpOptions{JsonCGAL::FileFormat::json, JsonCGAL::JsonSchema::compact, -1}),
+	          "[[\"point_2\",[0.1,-2.5]],[\"point_2\",[0.33333334,7.25]]]");
+
+	std::string binary = create_json_data.dump_to_string(JsonCGAL::FileFormat::binary);
+	ASSERT_EQ(binary.size(), JsonCGAL::binary_header_size + JsonCGAL::binary_block_header_size + 4 * sizeof(float));
+	FloatJsonCGAL load_json_data;
+	ASSERT_TRUE(load_json_data.load_from_string(binary));
+	ASSERT_TRUE(load_json_data.view<FloatJsonCGAL::Point_2d>()[1] == create_json_data.view<FloatJsonCGAL::Point_2d>()[1]);
+
+	/* double precision containers read single precision files, and the other way around */
+	JsonCGAL::JsonCGAL double_json_data;
+	ASSERT_TRUE(double_json_data.load_from_string(binary));
+	ASSERT_EQ(double_json_data.view<JsonCGAL::Point_2d>()[0].x(), 0.1f);
+	FloatJsonCGAL reload_json_data;
+	ASSERT_TRUE(reload_json_data.load_from_string(double_json_data.dump_to_string(JsonCGAL::FileFormat::binary)));
+	ASSERT_EQ(reload_json_data.dump_to_string(JsonCGAL::FileFormat::binary), binary);
+}
+
+TEST(BinaryTests, TestTiledRegionLoadReadsOnlyTouchedTiles)
+{
+	std::string filename = temp_file("test_tiled.jcgt");
+	JsonCGAL::JsonCGAL json_data;
+	std::mt19937 generator(7);
+	std::uniform_real_distribution<double> coordinate(-100.0, 100.0);
+	for (int i = 0; i < 5000; i++)
+	{
+		Kernel::Point_2 p(coordinate(generator), coordinate(generator));
+		json_data.emplace_object<JsonCGAL::Point_2d>(p.x(), p.y());
+		json_data.emplace_object<JsonCGAL::Segment_2d>(p, Kernel::Point_2(p.x() + 1.0, p.y() - 1.0));
+	}
+	add_all_types(json_data);
+
+	JsonCGAL::DumpOptions options;
+	options.format = JsonCGAL::FileFormat::tiled;
+	options.tile_objects = 256;
+	std::string tiled = json_data.dump_to_string(options);
+	std::vector<JsonCGAL::TileEntry> tiles;
+	JsonCGAL::MemoryStreamBuffer buffer(tiled.data(), tiled.size());
+	std::istream input(&buffer);
+	ASSERT_TRUE(JsonCGAL::read_tile_index(input, tiled.size(), tiles));
+	ASSERT_GT(tiles.size(), 40);
+
+	/* every object comes back, grouped by tile */
+	JsonCGAL::LoadOptions load_options;
+	load_options.threads = 4;
+	JsonCGAL::JsonCGAL full_json_data;
+	ASSERT_TRUE(full_json_data.load_from_string(tiled, load_options));
+	ASSERT_EQ(full_json_data.size(), json_data.size());
+	for (std::size_t type = 0; type < JsonCGAL::supported_type_count; type++)
+	{
+		ASSERT_EQ(full_json_data.count(static_cast<JsonCGAL::SupportedTypes::SupportedTypes>(type)), json_data.count(static_cast<JsonCGAL::SupportedTypes::SupportedTypes>(type)));
+	}
+	std::vector<double> expected_x;
+	std::vector<double> loaded_x;
+	for (const JsonCGAL::Point_2d &point : json_data.view<JsonCGAL::Point_2d>())
+	{
+		expected_x.push_back(point.x());
+	}
+	for (const JsonCGAL::Point_2d &point : full_json_data.view<JsonCGAL::Point_2d>())
+	{
+		loaded_x.push_back(point.x());
+	}
+	std::sort(expected_x.begin(), expected_x.end());
+	std::sort(loaded_x.begin(), loaded_x.end());
+	ASSERT_EQ(loaded_x, expected_x);
+
+	/* a region load keeps the same objects from the tiled and the binary format */
+	Kernel::Iso_rectangle_2 region(Kernel::Point_2(-10, -10), Kernel::Point_2(15, 5));
+	JsonCGAL::JsonCGAL binary_json_data;
+	ASSERT_TRUE(binary_json_data.load_from_string(json_data.dump_to_string(JsonCGAL::FileFormat::binary), region));
+	for (unsigned threads : {1u, 4u})
+	{
+		load_options.threads = threads;
+		JsonCGAL::JsonCGAL region_json_data;
+		ASSERT_TRUE(region_json_data.load_from_string(tiled, region, load_options));
+		ASSERT_EQ(region_json_data.size(), binary_json_data.size());
+		for (std::size_t type = 0; type < JsonCGAL::supported_type_count; type++)
+		{
+			ASSERT_EQ(region_json_data.count(static_cast<JsonCGAL::SupportedTypes::SupportedTypes>(type)), binary_json_data.count(static_cast<JsonCGAL::SupportedTypes::SupportedTypes>(type)));
+		}
+	}
+
+	/* tiles away from the region are never read, so damaging one only breaks full loads */
+	std::size_t far = 0;
+	for (; far < tiles.size(); far++)
+	{
+		if (tiles[far].xmin > 50 && tiles[far].ymin > 50)
+		{
+			break;
+		}
+	}
+	ASSERT_LT(far, tiles.size());
+	tiled[tiles[far].offset] = 'X';
+	JsonCGAL::JsonCGAL damaged_json_data;
+	ASSERT_TRUE(damaged_json_data.load_from_string(tiled, region));
+	ASSERT_EQ(damaged_json_data.size(), binary_json_data.size());
+	ASSERT_FALSE(damaged_json_data.load_from_string(tiled));
+	ASSERT_EQ(damaged_json_data.size(), binary_json_data.size());
+
+	/* compressed tiles are compressed one by one and stay independently readable */
+	if (JsonCGAL::compression_supported(JsonCGAL::Compression::gzip))
+	{
+		JsonCGAL::DumpOptions compressed = options;
+		compressed.compression = JsonCGAL::Compression::gzip;
+		JsonCGAL::JsonCGAL compressed_json_data;
+		ASSERT_TRUE(compressed_json_data.load_from_string(json_data.dump_to_string(compressed), region));
+		ASSERT_EQ(compressed_json_data.size(), binary_json_data.size());
+	}
+
+	/* files read without a memory mapping seek to the tiles they need */
+	load_options.memory_map = false;
+	ASSERT_TRUE(json_data.dump(filename, options));
+	JsonCGAL::JsonCGAL file_json_data;
+	ASSERT_TRUE(file_json_data.load(filename, region, load_options));
+	ASSERT_EQ(file_json_data.size(), binary_json_data.size());
+	std::size_t streamed = 0;
+	ASSERT_TRUE(JsonCGAL::JsonCGAL::for_each_object<JsonCGAL::Segment_2d>(filename, [&streamed](const JsonCGAL::Segment_2d &) { streamed++; }, load_options));
+	ASSERT_EQ(streamed, json_data.count<JsonCGAL::Segment_2d>());
+	std::remove(filename.c_str());
+}
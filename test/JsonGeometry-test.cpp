@@ -9,13 +9,28 @@
  * 
  */
 
+#include <algorithm>
+#include <cstdio>
+#include <future>
+#include <random>
+#include <string>
+
 #include "gtest/gtest.h"
 #include "JsonCGAL.h"
 #include "JsonCGALTypes.h"
+#include "JsonCGALStreams.h"
+#include "JsonCGALReadAhead.h"
 #include "json.hpp"
 #include "cgal_kernel_config.h"
+#include <CGAL/intersections.h>
 
 
+/* path of a scratch file in the test temporary directory */
+static std::string temp_file(const std::string &name)
+{
+	return ::testing::TempDir() + name;
+}
+
 TEST(JsonCGALTests, TestLoadInvalidFileReturnsFalse)
 {
 	JsonCGAL::JsonCGAL json_data;
@@ -65,21 +80,25 @@ TEST(JsonCGALTests, TestMultipleVariantTypes)
 
 TEST(JsonCGALTests, TestDumpingPointsToFileWorks)
 {
+	std::string filename = temp_file("test_dump.json");
 	JsonCGAL::JsonCGAL json_data;
 	CGAL_list<JsonCGAL::Point_2d> points;
 	points.push_back(JsonCGAL::Point_2d(1, 0));
 	points.push_back(JsonCGAL::Point_2d(-1, -1));
 	json_data.add_objects(points);
-	ASSERT_TRUE(json_data.dump("test_dump.json"));
+	ASSERT_TRUE(json_data.dump(filename));
+	std::remove(filename.c_str());
 }
 
 TEST(JsonCGALTests, TestingDumpingSegmentsToFileWorks)
 {
+	std::string filename = temp_file("test_dump.json");
 	JsonCGAL::JsonCGAL json_data;
 	CGAL_list<JsonCGAL::Segment_2d> segments;
 	segments.push_back(JsonCGAL::Segment_2d(JsonCGAL::Point_2d(0, 0), JsonCGAL::Point_2d(-1, -1)));
 	json_data.add_objects(segments);
-	ASSERT_TRUE(json_data.dump("test_dump.json"));
+	ASSERT_TRUE(json_data.dump(filename));
+	std::remove(filename.c_str());
 }
 
 TEST(JsonCGALTests, TestLoadingFromStringWorks)
@@ -97,6 +116,745 @@ TEST(JsonCGALTests, TestLoadingFromStringWorks)
 	ASSERT_EQ(points_validate[0].x(), 1);
 }
 
+TEST(JsonCGALTests, TestLoadingSegmentsAndLinesFromString)
+{
+	JsonCGAL::JsonCGAL json_data;
+	std::string test_string = R"([
+		{"type": "segment_2", "points": [{"type": "point_2", "coordinates": [0.5, 1]}, {"type": "point_2", "coordinates": [-2, 3.25]}]},
+		{"points": [{"coordinates": [0, 0], "type": "point_2"}, {"coordinates": [1, 1], "type": "point_2"}], "type": "line_2"},
+		{"coordinates": [4, 5], "type": "point_2"}
+	])";
+	ASSERT_TRUE(json_data.load_from_string(test_string));
+	CGAL_list<JsonCGAL::Segment_2d> segments = json_data.get_objects<JsonCGAL::Segment_2d>(JsonCGAL::Segment_2d());
+	CGAL_list<JsonCGAL::Line_2d> lines = json_data.get_objects<JsonCGAL::Line_2d>(JsonCGAL::Line_2d());
+	CGAL_list<JsonCGAL::Point_2d> points = json_data.get_objects<JsonCGAL::Point_2d>(JsonCGAL::Point_2d());
+	ASSERT_EQ(segments.size(), 1);
+	ASSERT_EQ(lines.size(), 1);
+	ASSERT_EQ(points.size(), 1);
+	ASSERT_EQ(segments[0].source().x(), 0.5);
+	ASSERT_EQ(segments[0].target().y(), 3.25);
+	ASSERT_EQ(points[0].y(), 5);
+}
+
+TEST(JsonCGALTests, TestLoadingInvalidStringKeepsExistingObjects)
+{
+	JsonCGAL::JsonCGAL json_data;
+	ASSERT_TRUE(json_data.load_from_string(R"([{"type": "point_2", "coordinates": [1, 2]}])"));
+	ASSERT_FALSE(json_data.load_from_string(R"([{"type": "point_2", "coordinates": [3, 4]}, {"type": )"));
+	ASSERT_FALSE(json_data.load_from_string(R"([{"type": "point_2", "coordinates": [3]}])"));
+	ASSERT_FALSE(json_data.load_from_string(R"({"type": "point_2", "coordinates": [3, 4]})"));
+	CGAL_list<JsonCGAL::Point_2d> points = json_data.get_objects<JsonCGAL::Point_2d>(JsonCGAL::Point_2d());
+	ASSERT_EQ(points.size(), 1);
+	ASSERT_EQ(points[0].x(), 1);
+}
+
+TEST(JsonCGALTests, TestLoadingDumpedFileWorks)
+{
+	std::string filename = temp_file("test_load_dump.json");
+	JsonCGAL::JsonCGAL create_json_data;
+	JsonCGAL::JsonCGAL load_json_data;
+	CGAL_list<JsonCGAL::Segment_2d> segments;
+	segments.push_back(JsonCGAL::Segment_2d(JsonCGAL::Point_2d(0, 0), JsonCGAL::Point_2d(-1, -1)));
+	create_json_data.add_objects(segments);
+	ASSERT_TRUE(create_json_data.dump(filename));
+	ASSERT_TRUE(load_json_data.load(filename));
+	CGAL_list<JsonCGAL::Segment_2d> segments_validate = load_json_data.get_objects<JsonCGAL::Segment_2d>(JsonCGAL::Segment_2d());
+	ASSERT_EQ(segments_validate.size(), 1);
+	ASSERT_EQ(segments_validate[0].target().x(), -1);
+	std::remove(filename.c_str());
+}
+
+TEST(JsonCGALTests, TestDumpPreservesInsertionOrder)
+{
+	JsonCGAL::JsonCGAL json_data;
+	json_data.add_objects(CGAL_list<JsonCGAL::Point_2d>{JsonCGAL::Point_2d(1, 0)});
+	json_data.add_objects(CGAL_list<JsonCGAL::Segment_2d>{JsonCGAL::Segment_2d(JsonCGAL::Point_2d(0, 0), JsonCGAL::Point_2d(-1, -1))});
+	json_data.add_objects(CGAL_list<JsonCGAL::Point_2d>{JsonCGAL::Point_2d(2, 3)});
+	nlohmann::json json = nlohmann::json::parse(json_data.dump_to_string());
+	ASSERT_EQ(json.size(), 3);
+	ASSERT_EQ(json[0]["type"], "point_2");
+	ASSERT_EQ(json[1]["type"], "segment_2");
+	ASSERT_EQ(json[2]["type"], "point_2");
+	ASSERT_EQ(json[2]["coordinates"][0], 2);
+}
+
+TEST(JsonCGALTests, TestCountingObjectsByType)
+{
+	JsonCGAL::JsonCGAL json_data;
+	ASSERT_EQ(json_data.size(), 0);
+	json_data.add_objects(CGAL_list<JsonCGAL::Point_2d>{JsonCGAL::Point_2d(1, 0), JsonCGAL::Point_2d(2, 0)});
+	json_data.add_objects(CGAL_list<JsonCGAL::Segment_2d>{JsonCGAL::Segment_2d(JsonCGAL::Point_2d(0, 0), JsonCGAL::Point_2d(-1, -1))});
+	ASSERT_EQ(json_data.count<JsonCGAL::Point_2d>(), 2);
+	ASSERT_EQ(json_data.count<JsonCGAL::Segment_2d>(), 1);
+	ASSERT_EQ(json_data.count<JsonCGAL::Line_2d>(), 0);
+	ASSERT_EQ(json_data.count(JsonCGAL::SupportedTypes::segment_2), 1);
+	ASSERT_EQ(json_data.size(), 3);
+}
+
+TEST(JsonCGALTests, TestViewingObjectsWithoutCopying)
+{
+	JsonCGAL::JsonCGAL json_data;
+	json_data.add_objects(CGAL_list<JsonCGAL::Point_2d>{JsonCGAL::Point_2d(1, 0), JsonCGAL::Point_2d(2, 5)});
+	json_data.add_objects(CGAL_list<JsonCGAL::Segment_2d>{JsonCGAL::Segment_2d(JsonCGAL::Point_2d(0, 0), JsonCGAL::Point_2d(-1, -1))});
+	JsonCGAL::ObjectView<JsonCGAL::Point_2d> points = json_data.view<JsonCGAL::Point_2d>();
+	ASSERT_EQ(points.size(), 2);
+	ASSERT_EQ(points[1].y(), 5);
+	ASSERT_EQ(&points[0], &json_data.view<JsonCGAL::Point_2d>().front());
+	double sum = 0;
+	for (const JsonCGAL::Point_2d &point : points)
+	{
+		sum += point.x();
+	}
+	ASSERT_EQ(sum, 3);
+	ASSERT_TRUE(json_data.view<JsonCGAL::Line_2d>().empty());
+}
+
+TEST(JsonCGALTests, TestBulkAddingKernelObjects)
+{
+	JsonCGAL::JsonCGAL json_data;
+	std::vector<Kernel::Point_2> points = {Kernel::Point_2(1, 2), Kernel::Point_2(3, 4)};
+	json_data.add_objects(points.begin(), points.end());
+	json_data.add_objects(CGAL_list<Kernel::Segment_2>{Kernel::Segment_2(Kernel::Point_2(0, 0), Kernel::Point_2(1, 1))});
+	JsonCGAL::Point_2d &point = json_data.emplace_object<JsonCGAL::Point_2d>(5, 6);
+	ASSERT_EQ(point.y(), 6);
+	ASSERT_EQ(json_data.size(), 4);
+	ASSERT_EQ(json_data.count<JsonCGAL::Point_2d>(), 3);
+	ASSERT_EQ(json_data.view<JsonCGAL::Segment_2d>()[0].target().x(), 1);
+	nlohmann::json json = nlohmann::json::parse(json_data.dump_to_string());
+	ASSERT_EQ(json[2]["type"], "segment_2");
+	ASSERT_EQ(json[3]["coordinates"][0], 5);
+}
+
+TEST(JsonCGALTests, TestMovingContainerTakesItsStorage)
+{
+	JsonCGAL::JsonCGAL json_data;
+	CGAL_list<JsonCGAL::Point_2d> points{JsonCGAL::Point_2d(1, 0), JsonCGAL::Point_2d(2, 5)};
+	const JsonCGAL::Point_2d *data = points.data();
+	json_data.add_objects(std::move(points));
+	ASSERT_EQ(&json_data.view<JsonCGAL::Point_2d>().front(), data);
+	json_data.add_objects(CGAL_list<JsonCGAL::Point_2d>{JsonCGAL::Point_2d(7, 8)});
+	ASSERT_EQ(json_data.size(), 3);
+	ASSERT_EQ(json_data.view<JsonCGAL::Point_2d>()[2].x(), 7);
+}
+
+TEST(JsonCGALTests, TestClearReleasesAllObjects)
+{
+	JsonCGAL::JsonCGAL json_data;
+	json_data.reserve<JsonCGAL::Point_2d>(100);
+	JsonCGAL::ObjectView<JsonCGAL::Point_2d>::const_iterator first = json_data.view<JsonCGAL::Point_2d>().begin();
+	json_data.add_objects(CGAL_list<JsonCGAL::Point_2d>{JsonCGAL::Point_2d(1, 0), JsonCGAL::Point_2d(2, 5)});
+	ASSERT_TRUE(json_data.view<JsonCGAL::Point_2d>().begin() == first);
+	json_data.add_objects(CGAL_list<JsonCGAL::Segment_2d>{JsonCGAL::Segment_2d(JsonCGAL::Point_2d(0, 0), JsonCGAL::Point_2d(-1, -1))});
+	json_data.clear();
+	ASSERT_EQ(json_data.size(), 0);
+	ASSERT_EQ(json_data.count<JsonCGAL::Point_2d>(), 0);
+	ASSERT_EQ(json_data.dump_to_string(), "[]");
+	json_data.add_objects(CGAL_list<JsonCGAL::Point_2d>{JsonCGAL::Point_2d(3, 4)});
+	ASSERT_EQ(json_data.size(), 1);
+	ASSERT_EQ(json_data.view<JsonCGAL::Point_2d>()[0].x(), 3);
+}
+
+TEST(JsonCGALTests, TestLoadingWithAndWithoutMemoryMapMatches)
+{
+	std::string filename = temp_file("test_mapped.json");
+	JsonCGAL::JsonCGAL create_json_data;
+	JsonCGAL::JsonCGAL mapped_json_data;
+	JsonCGAL::JsonCGAL stream_json_data;
+	JsonCGAL::LoadOptions options;
+	create_json_data.add_objects(CGAL_list<JsonCGAL::Point_2d>{JsonCGAL::Point_2d(1, 0), JsonCGAL::Point_2d(-1, 2.5)});
+	ASSERT_TRUE(create_json_data.dump(filename));
+	options.huge_pages = true;
+	ASSERT_TRUE(mapped_json_data.load(filename, options));
+	options.memory_map = false;
+	ASSERT_TRUE(stream_json_data.load(filename, options));
+	ASSERT_EQ(mapped_json_data.dump_to_string(), stream_json_data.dump_to_string());
+	ASSERT_EQ(mapped_json_data.view<JsonCGAL::Point_2d>()[1].y(), 2.5);
+	std::remove(filename.c_str());
+}
+
+TEST(JsonCGALTests, TestLoadingEmptyFileReturnsFalse)
+{
+	std::string filename = temp_file("test_empty.json");
+	std::ofstream(filename).close();
+	JsonCGAL::JsonCGAL json_data;
+	ASSERT_FALSE(json_data.load(filename));
+	std::remove(filename.c_str());
+}
+
+/* build a large mixed type container for the multi-threaded tests */
+static void add_mixed_objects(JsonCGAL::JsonCGAL &json_data, int count)
+{
+	for (int i = 0; i < count; i++)
+	{
+		json_data.add_objects(CGAL_list<JsonCGAL::Point_2d>{JsonCGAL::Point_2d(i, -i * 0.5)});
+		if (i % 3 == 0)
+		{
+			json_data.add_objects(CGAL_list<JsonCGAL::Segment_2d>{JsonCGAL::Segment_2d(JsonCGAL::Point_2d(i, 0), JsonCGAL::Point_2d(0, i))});
+		}
+	}
+}
+
+TEST(JsonCGALTests, TestParallelLoadMatchesSerialLoad)
+{
+	JsonCGAL::JsonCGAL create_json_data;
+	JsonCGAL::JsonCGAL serial_json_data;
+	JsonCGAL::JsonCGAL parallel_json_data;
+	JsonCGAL::LoadOptions options;
+	add_mixed_objects(create_json_data, 20000);
+	std::string test_string = create_json_data.dump_to_string();
+	options.threads = 4;
+	ASSERT_TRUE(serial_json_data.load_from_string(test_string));
+	ASSERT_TRUE(parallel_json_data.load_from_string(test_string, options));
+	ASSERT_EQ(parallel_json_data.size(), create_json_data.size());
+	ASSERT_EQ(parallel_json_data.count<JsonCGAL::Segment_2d>(), serial_json_data.count<JsonCGAL::Segment_2d>());
+	ASSERT_EQ(parallel_json_data.dump_to_string(), test_string);
+}
+
+TEST(JsonCGALTests, TestParallelLoadRejectsInvalidInput)
+{
+	JsonCGAL::JsonCGAL create_json_data;
+	JsonCGAL::JsonCGAL load_json_data;
+	JsonCGAL::LoadOptions options;
+	add_mixed_objects(create_json_data, 20000);
+	std::string test_string = create_json_data.dump_to_string();
+	options.threads = 4;
+	std::string truncated = test_string.substr(0, test_string.size() / 2);
+	ASSERT_FALSE(load_json_data.load_from_string(truncated, options));
+	std::string trailing_comma = test_string.substr(0, test_string.size() - 1) + ",]";
+	ASSERT_FALSE(load_json_data.load_from_string(trailing_comma, options));
+	std::string bad_value = test_string;
+	bad_value.replace(bad_value.rfind("point_2"), 7, "point_9");
+	ASSERT_FALSE(load_json_data.load_from_string(bad_value, options));
+	ASSERT_EQ(load_json_data.size(), 0);
+}
+
+TEST(JsonCGALTests, TestParallelDumpMatchesSerialDump)
+{
+	std::string filename = temp_file("test_parallel_dump.json");
+	JsonCGAL::JsonCGAL json_data;
+	JsonCGAL::DumpOptions options;
+	add_mixed_objects(json_data, 40000);
+	std::string serial = json_data.dump_to_string(options);
+	options.threads = 3;
+	ASSERT_EQ(json_data.dump_to_string(options), serial);
+	options.indent = -1;
+	std::string parallel_compact = json_data.dump_to_string(options);
+	options.threads = 1;
+	ASSERT_EQ(parallel_compact, json_data.dump_to_string(options));
+	options.indent = 4;
+	options.threads = 3;
+	ASSERT_TRUE(json_data.dump(filename, options));
+	std::ifstream infile(filename, std::ios::binary);
+	std::string file_contents((std::istreambuf_iterator<char>(infile)), std::istreambuf_iterator<char>());
+	ASSERT_EQ(file_contents, serial + "\n");
+	std::remove(filename.c_str());
+}
+
+TEST(JsonCGALTests, TestLazyLoadDecodesTypesOnFirstAccess)
+{
+	std::string filename = temp_file("test_lazy.json");
+	JsonCGAL::JsonCGAL create_json_data;
+	JsonCGAL::JsonCGAL lazy_json_data;
+	JsonCGAL::LoadOptions options;
+	add_mixed_objects(create_json_data, 3000);
+	std::string test_string = create_json_data.dump_to_string();
+	options.lazy = true;
+	ASSERT_TRUE(lazy_json_data.load_from_string(test_string, options));
+	ASSERT_EQ(lazy_json_data.size(), create_json_data.size());
+	ASSERT_EQ(lazy_json_data.count<JsonCGAL::Segment_2d>(), 1000);
+	JsonCGAL::ObjectView<JsonCGAL::Segment_2d> segments = lazy_json_data.view<JsonCGAL::Segment_2d>();
+	ASSERT_EQ(segments.size(), 1000);
+	ASSERT_EQ(segments[1].source().x(), 3);
+	lazy_json_data.add_objects(CGAL_list<JsonCGAL::Point_2d>{JsonCGAL::Point_2d(7, 8)});
+	create_json_data.add_objects(CGAL_list<JsonCGAL::Point_2d>{JsonCGAL::Point_2d(7, 8)});
+	ASSERT_EQ(lazy_json_data.dump_to_string(), create_json_data.dump_to_string());
+
+	JsonCGAL::DumpOptions dump_options;
+	dump_options.schema = JsonCGAL::JsonSchema::compact;
+	create_json_data.add_objects(CGAL_list<JsonCGAL::Circle_2d>{JsonCGAL::Circle_2d(JsonCGAL::Point_2d(1, 2), 0.25, CGAL::CLOCKWISE)});
+	ASSERT_TRUE(create_json_data.dump(filename, dump_options));
+	JsonCGAL::JsonCGAL lazy_file_data;
+	ASSERT_TRUE(lazy_file_data.load(filename, options));
+	ASSERT_EQ(lazy_file_data.view<JsonCGAL::Circle_2d>()[0].squared_radius(), 0.25);
+	ASSERT_EQ(lazy_file_data.dump_to_string(dump_options), create_json_data.dump_to_string(dump_options));
+	std::remove(filename.c_str());
+}
+
+TEST(JsonCGALTests, TestLazyLoadDropsTypesThatFailToDecode)
+{
+	JsonCGAL::JsonCGAL json_data;
+	JsonCGAL::LoadOptions options;
+	options.lazy = true;
+	std::string test_string = R"([
+		{"type": "point_2", "coordinates": [1, 2]},
+		{"type": "segment_2", "points": [{"type": "point_2", "coordinates": [0, 0]}, {"type": "point_2", "coordinates": [1, 1]}]},
+		{"type": "point_2", "coordinates": ["x", 2]}
+	])";
+	ASSERT_TRUE(json_data.load_from_string(test_string, options));
+	ASSERT_EQ(json_data.size(), 3);
+	ASSERT_EQ(json_data.view<JsonCGAL::Point_2d>().size(), 0);
+	ASSERT_EQ(json_data.size(), 1);
+	ASSERT_EQ(json_data.view<JsonCGAL::Segment_2d>().size(), 1);
+	ASSERT_FALSE(json_data.load_from_string(R"([{"type": "point_9", "coordinates": [1, 2]}])", options));
+	ASSERT_FALSE(json_data.load_from_string(R"([{"type": "point_2", "coordinates": [1, 2]})", options));
+	ASSERT_EQ(json_data.size(), 1);
+
+	/* decode_all reports the failure before any accessor drops the objects */
+	json_data.clear();
+	ASSERT_TRUE(json_data.load_from_string(test_string, options));
+	ASSERT_FALSE(json_data.decode_all());
+	ASSERT_EQ(json_data.size(), 1);
+	ASSERT_EQ(json_data.count<JsonCGAL::Segment_2d>(), 1);
+	ASSERT_TRUE(json_data.decode_all());
+}
+
+TEST(JsonCGALTests, TestJsonLinesRoundTrip)
+{
+	std::string filename = temp_file("test_lines.jsonl");
+	JsonCGAL::JsonCGAL json_data;
+	JsonCGAL::JsonCGAL lines_data;
+	JsonCGAL::JsonCGAL stream_data;
+	JsonCGAL::DumpOptions options;
+	JsonCGAL::LoadOptions load_options;
+	add_mixed_objects(json_data, 3000);
+	options.format = JsonCGAL::FileFormat::json_lines;
+	std::string lines = json_data.dump_to_string(options);
+	ASSERT_EQ(lines.substr(0, lines.find('\n') + 1), "[\"point_2\",[0.0,0.0]]\n");
+	ASSERT_EQ(static_cast<std::size_t>(std::count(lines.begin(), lines.end(), '\n')), json_data.size());
+	ASSERT_TRUE(lines_data.load_from_string(lines));
+	ASSERT_EQ(lines_data.dump_to_string(), json_data.dump_to_string());
+
+	options.schema = JsonCGAL::JsonSchema::compact;
+	options.threads = 3;
+	ASSERT_TRUE(json_data.dump(filename, options));
+	load_options.memory_map = false;
+	ASSERT_TRUE(stream_data.load(filename, load_options));
+	ASSERT_EQ(stream_data.dump_to_string(), json_data.dump_to_string());
+	std::remove(filename.c_str());
+}
+
+TEST(JsonCGALTests, TestJsonLinesAppendAndRecoverFromTruncation)
+{
+	std::string filename = temp_file("test_append.jsonl");
+	JsonCGAL::JsonCGAL first;
+	JsonCGAL::JsonCGAL second;
+	JsonCGAL::JsonCGAL load_json_data;
+	JsonCGAL::DumpOptions options;
+	options.format = JsonCGAL::FileFormat::json_lines;
+	first.add_objects(CGAL_list<JsonCGAL::Point_2d>{JsonCGAL::Point_2d(1, 2), JsonCGAL::Point_2d(3, 4)});
+	second.add_objects(CGAL_list<JsonCGAL::Segment_2d>{JsonCGAL::Segment_2d(JsonCGAL::Point_2d(0, 0), JsonCGAL::Point_2d(5, 6))});
+	ASSERT_TRUE(first.dump(filename, options));
+
+	/* an interrupted writer leaves half a line behind */
+	std::ofstream(filename, std::ios::app | std::ios::binary) << "{\"coordinates\":[7.0,";
+	ASSERT_TRUE(load_json_data.load(filename));
+	ASSERT_EQ(load_json_data.size(), 2);
+
+	options.append = true;
+	ASSERT_TRUE(second.dump(filename, options));
+	load_json_data.clear();
+	ASSERT_TRUE(load_json_data.load(filename));
+	ASSERT_EQ(load_json_data.count<JsonCGAL::Point_2d>(), 2);
+	ASSERT_EQ(load_json_data.view<JsonCGAL::Segment_2d>()[0].target().y(), 6);
+
+	/* a complete last line without a newline is kept, and ended before the append */
+	std::ofstream(filename, std::ios::trunc | std::ios::binary) << "{\"type\":\"point_2\",\"coordinates\":[1.0,2.0]}\n"
+	                                                            << "{\"type\":\"point_2\",\"coordinates\":[3.0,4.0]}";
+	ASSERT_TRUE(second.dump(filename, options));
+	load_json_data.clear();
+	ASSERT_TRUE(load_json_data.load(filename));
+	ASSERT_EQ(load_json_data.count<JsonCGAL::Point_2d>(), 2);
+	ASSERT_EQ(load_json_data.view<JsonCGAL::Point_2d>()[1].x(), 3);
+	ASSERT_EQ(load_json_data.count<JsonCGAL::Segment_2d>(), 1);
+
+	/* the same for a file holding a single unterminated line */
+	std::ofstream(filename, std::ios::trunc | std::ios::binary) << "[\"point_2\",[5.0,6.0]]";
+	ASSERT_TRUE(second.dump(filename, options));
+	load_json_data.clear();
+	ASSERT_TRUE(load_json_data.load(filename));
+	ASSERT_EQ(load_json_data.size(), 2);
+	ASSERT_EQ(load_json_data.view<JsonCGAL::Point_2d>()[0].y(), 6);
+
+	options.format = JsonCGAL::FileFormat::json;
+	ASSERT_FALSE(second.dump(filename, options));
+	std::remove(filename.c_str());
+}
+
+TEST(JsonCGALTests, TestInvalidJsonLineIsRejected)
+{
+	JsonCGAL::JsonCGAL json_data;
+	std::string lines = "{\"type\": \"point_2\", \"coordinates\": [1, 2]}\n"
+	                    "[\"point_2\", [3, 4]] [\"point_2\", [5, 6]]\n"
+	                    "{\"type\": \"point_2\", \"coordinates\": [7, 8]}\n";
+	ASSERT_FALSE(json_data.load_from_string(lines));
+	lines = "{\"type\": \"point_2\", \"coordinates\": [1, 2]}\n\n"
+	        "{\"type\": \"point\\u005f2\", \"coordinates\": [3, 4]}\r\n";
+	ASSERT_TRUE(json_data.load_from_string(lines));
+	ASSERT_EQ(json_data.size(), 2);
+}
+
+TEST(JsonCGALTests, TestForEachObjectMatchesLoad)
+{
+	std::string filename = temp_file("test_for_each.json");
+	JsonCGAL::JsonCGAL json_data;
+	JsonCGAL::DumpOptions options;
+	JsonCGAL::LoadOptions load_options;
+	add_mixed_objects(json_data, 10000);
+	CGAL_list<JsonCGAL::Point_2d> points = json_data.get_objects<JsonCGAL::Point_2d>();
+
+	const JsonCGAL::FileFormat::FileFormat formats[] = {JsonCGAL::FileFormat::json, JsonCGAL::FileFormat::binary, JsonCGAL::FileFormat::json_lines};
+	const JsonCGAL::JsonSchema::JsonSchema schemas[] = {JsonCGAL::JsonSchema::nested, JsonCGAL::JsonSchema::compact, JsonCGAL::JsonSchema::columnar};
+	for (JsonCGAL::FileFormat::FileFormat format : formats)
+	{
+		for (JsonCGAL::JsonSchema::JsonSchema schema : schemas)
+		{
+			options.format = format;
+			options.schema = schema;
+			ASSERT_TRUE(json_data.dump(filename, options));
+			for (bool memory_map : {true, false})
+			{
+				CGAL_list<JsonCGAL::Point_2d> visited;
+				std::size_t segments = 0;
+				load_options.memory_map = memory_map;
+				ASSERT_TRUE(JsonCGAL::JsonCGAL::for_each_object<JsonCGAL::Point_2d>(filename, [&visited](const JsonCGAL::Point_2d &point) { visited.push_back(point); }, load_options));
+				ASSERT_TRUE(JsonCGAL::JsonCGAL::for_each_object<JsonCGAL::Segment_2d>(filename, [&segments](const JsonCGAL::Segment_2d &) { segments++; }, load_options));
+				ASSERT_EQ(visited, points) << format << " " << schema << " " << memory_map;
+				ASSERT_EQ(segments, json_data.count<JsonCGAL::Segment_2d>());
+			}
+		}
+	}
+	std::remove(filename.c_str());
+}
+
+TEST(JsonCGALTests, TestForEachObjectFallbackDoesNotRepeatObjects)
+{
+	std::string filename = temp_file("test_for_each_escaped.json");
+	/* the escaped key makes the fast reader give up after batches were handed over */
+	std::string json_string = "[";
+	for (int i = 0; i < 20000; i++)
+	{
+		json_string += (i == 0) ? "" : ",";
+		json_string += (i == 12345) ? R"({"type": "point\u005f2", "coordinates": [1, 2]})" : R"({"type": "point_2", "coordinates": [1, 2]})";
+	}
+	json_string += "]";
+	std::ofstream(filename, std::ios::binary) << json_string;
+	std::size_t count = 0;
+	ASSERT_TRUE(JsonCGAL::JsonCGAL::for_each_object<JsonCGAL::Point_2d>(filename, [&count](const JsonCGAL::Point_2d &) { count++; }));
+	ASSERT_EQ(count, 20000u);
+
+	std::ofstream(filename, std::ios::binary) << "[{\"type\": \"point_2\", \"coordinates\": [1]}]";
+	ASSERT_FALSE(JsonCGAL::JsonCGAL::for_each_object<JsonCGAL::Point_2d>(filename, [](const JsonCGAL::Point_2d &) {}));
+	ASSERT_FALSE(JsonCGAL::JsonCGAL::for_each_object<JsonCGAL::Point_2d>("test_missing_file.json", [](const JsonCGAL::Point_2d &) {}));
+	std::remove(filename.c_str());
+}
+
+TEST(JsonCGALTests, TestAsyncLoadMatchesLoad)
+{
+	std::string filename = temp_file("test_async.json");
+	JsonCGAL::JsonCGAL json_data;
+	JsonCGAL::LoadOptions load_options;
+	add_mixed_objects(json_data, 5000);
+	std::string expected = json_data.dump_to_string();
+
+	const JsonCGAL::FileFormat::FileFormat formats[] = {JsonCGAL::FileFormat::json, JsonCGAL::FileFormat::binary, JsonCGAL::FileFormat::json_lines};
+	for (JsonCGAL::FileFormat::FileFormat format : formats)
+	{
+		ASSERT_TRUE(json_data.dump(filename, format));
+		for (bool memory_map : {true, false})
+		{
+			JsonCGAL::JsonCGAL async_data;
+			load_options.memory_map = memory_map;
+			std::future<bool> loaded = async_data.load_async(filename, load_options);
+			ASSERT_TRUE(loaded.get()) << format << " " << memory_map;
+			ASSERT_EQ(async_data.dump_to_string(), expected);
+		}
+	}
+	JsonCGAL::JsonCGAL missing;
+	ASSERT_FALSE(missing.load_async("test_missing_file.json").get());
+	std::remove(filename.c_str());
+}
+
+TEST(JsonCGALTests, TestReadAheadBufferReadsWholeSource)
+{
+	std::string text;
+	for (int i = 0; i < 10000; i++)
+	{
+		text += std::to_string(i) + ",";
+	}
+	JsonCGAL::MemoryStreamBuffer source(text.data(), text.size());
+	JsonCGAL::ReadAheadStreamBuffer read_ahead(source, 100);
+	std::istream input(&read_ahead);
+	std::string read((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+	ASSERT_EQ(read, text);
+
+	/* a reader stopped part way through must not hang */
+	JsonCGAL::MemoryStreamBuffer partial_source(text.data(), text.size());
+	JsonCGAL::ReadAheadStreamBuffer partial(partial_source, 100);
+	ASSERT_EQ(partial.sgetc(), '0');
+}
+
+TEST(JsonCGALTests, TestCompressedRoundTrip)
+{
+	std::string filename = temp_file("test_compressed.gz");
+	JsonCGAL::JsonCGAL json_data;
+	JsonCGAL::DumpOptions options;
+	JsonCGAL::LoadOptions load_options;
+	add_mixed_objects(json_data, 60000);
+	std::string expected = json_data.dump_to_string();
+	options.threads = 3;
+
+	const JsonCGAL::Compression::Compression compressions[] = {JsonCGAL::Compression::gzip, JsonCGAL::Compression::zstd};
+	const JsonCGAL::FileFormat::FileFormat formats[] = {JsonCGAL::FileFormat::json, JsonCGAL::FileFormat::binary, JsonCGAL::FileFormat::json_lines};
+	for (JsonCGAL::Compression::Compression compression : compressions)
+	{
+		if (!JsonCGAL::compression_supported(compression))
+		{
+			continue;
+		}
+		for (JsonCGAL::FileFormat::FileFormat format : formats)
+		{
+			options.compression = compression;
+			options.format = format;
+			ASSERT_TRUE(json_data.dump(filename, options));
+			for (bool memory_map : {true, false})
+			{
+				JsonCGAL::JsonCGAL load_json_data;
+				std::size_t points = 0;
+				load_options.memory_map = memory_map;
+				ASSERT_TRUE(load_json_data.load(filename, load_options)) << compression << " " << format;
+				ASSERT_EQ(load_json_data.dump_to_string(), expected);
+				ASSERT_TRUE(JsonCGAL::JsonCGAL::for_each_object<JsonCGAL::Point_2d>(filename, [&points](const JsonCGAL::Point_2d &) { points++; }, load_options));
+				ASSERT_EQ(points, json_data.count<JsonCGAL::Point_2d>());
+			}
+
+			std::string compressed = json_data.dump_to_string(options);
+			ASSERT_EQ(JsonCGAL::compressed_format(compressed.data(), compressed.size()), compression);
+			ASSERT_LT(compressed.size(), json_data.dump_to_string(format).size());
+			JsonCGAL::JsonCGAL string_data;
+			ASSERT_TRUE(string_data.load_from_string(compressed));
+			ASSERT_EQ(string_data.dump_to_string(), expected);
+
+			/* a truncated file is rejected as a whole */
+			JsonCGAL::JsonCGAL truncated;
+			ASSERT_FALSE(truncated.load_from_string(compressed.substr(0, compressed.size() - 3))) << compression << " " << format;
+			ASSERT_EQ(truncated.size(), 0u);
+		}
+	}
+	options.append = true;
+	ASSERT_FALSE(json_data.dump(filename, options));
+	std::remove(filename.c_str());
+}
+
+TEST(JsonCGALTests, TestEmptyCompressedOutputIsValid)
+{
+	JsonCGAL::JsonCGAL json_data;
+	JsonCGAL::DumpOptions options;
+	options.compression = JsonCGAL::Compression::gzip;
+	if (!JsonCGAL::compression_supported(options.compression))
+	{
+		GTEST_SKIP();
+	}
+	options.format = JsonCGAL::FileFormat::binary;
+	std::string compressed = json_data.dump_to_string(options);
+	JsonCGAL::JsonCGAL load_json_data;
+	ASSERT_TRUE(load_json_data.load_from_string(compressed));
+	ASSERT_EQ(load_json_data.size(), 0u);
+}
+
+TEST(JsonCGALTests, TestFailedCompressionIsReported)
+{
+	std::string filename = temp_file("test_failed_compression.jcgt");
+	JsonCGAL::JsonCGAL json_data;
+	JsonCGAL::DumpOptions options;
+	options.compression = JsonCGAL::Compression::gzip;
+	if (!JsonCGAL::compression_supported(options.compression))
+	{
+		GTEST_SKIP();
+	}
+	add_mixed_objects(json_data, 100);
+	/* zlib rejects the level, so the compressor fails to start */
+	options.compression_level = 42;
+	const JsonCGAL::FileFormat::FileFormat formats[] = {JsonCGAL::FileFormat::json, JsonCGAL::FileFormat::binary, JsonCGAL::FileFormat::tiled};
+	for (JsonCGAL::FileFormat::FileFormat format : formats)
+	{
+		options.format = format;
+		ASSERT_EQ(json_data.dump_to_string(options), "") << format;
+		ASSERT_FALSE(json_data.dump(filename, options)) << format;
+	}
+	std::remove(filename.c_str());
+}
+
+TEST(JsonCGALTests, TestContainerOnAnotherKernel)
+{
+	typedef CGAL::Exact_predicates_inexact_constructions_kernel Epick;
+	typedef JsonCGAL::BasicJsonCGAL<Epick> EpickJsonCGAL;
+	EpickJsonCGAL epick_data;
+	std::vector<Epick::Point_2> points = {Epick::Point_2(1, 2), Epick::Point_2(3, 4)};
+	epick_data.add_objects(points.begin(), points.end());
+	epick_data.add_objects(CGAL_list<Epick::Segment_2>{Epick::Segment_2(Epick::Point_2(0, 0), Epick::Point_2(1, 1))});
+	const Epick::Point_2 &point = epick_data.view<EpickJsonCGAL::Point_2d>()[1];
+	ASSERT_EQ(point.x(), 3);
+
+	JsonCGAL::JsonCGAL json_data;
+	json_data.add_objects(CGAL_list<JsonCGAL::Point_2d>{JsonCGAL::Point_2d(1, 2), JsonCGAL::Point_2d(3, 4)});
+	json_data.add_objects(CGAL_list<JsonCGAL::Segment_2d>{JsonCGAL::Segment_2d(Kernel::Point_2(0, 0), Kernel::Point_2(1, 1))});
+	ASSERT_EQ(epick_data.dump_to_string(), json_data.dump_to_string());
+
+	JsonCGAL::DumpOptions options;
+	options.format = JsonCGAL::FileFormat::binary;
+	EpickJsonCGAL load_epick_data;
+	ASSERT_TRUE(load_epick_data.load_from_string(json_data.dump_to_string(options)));
+	ASSERT_EQ(load_epick_data.count<EpickJsonCGAL::Segment_2d>(), 1);
+	ASSERT_EQ(load_epick_data.view<EpickJsonCGAL::Segment_2d>()[0].target().y(), 1);
+}
+
+TEST(JsonCGALTests, TestSpatialQueryMatchesScan)
+{
+	JsonCGAL::JsonCGAL json_data;
+	std::mt19937 generator(7);
+	std::uniform_real_distribution<double> coordinate(-100.0, 100.0);
+	std::uniform_real_distribution<double> offset(-5.0, 5.0);
+	for (int i = 0; i < 2000; i++)
+	{
+		Kernel::Point_2 p(coordinate(generator), coordinate(generator));
+		Kernel::Point_2 q(p.x() + offset(generator), p.y() + offset(generator));
+		json_data.emplace_object<JsonCGAL::Point_2d>(p.x(), p.y());
+		json_data.emplace_object<JsonCGAL::Segment_2d>(p, q);
+		if (i % 50 == 0)
+		{
+			json_data.emplace_object<JsonCGAL::Line_2d>(p, q);
+			json_data.emplace_object<JsonCGAL::Circle_2d>(q, 4.0);
+			json_data.emplace_object<JsonCGAL::Vector_2d>(p.x(), p.y());
+		}
+	}
+
+	for (int i = 0; i < 20; i++)
+	{
+		Kernel::Point_2 corner(coordinate(generator), coordinate(generator));
+		Kernel::Iso_rectangle_2 box(corner, Kernel::Point_2(corner.x() + 20 * std::abs(offset(generator)), corner.y() + 20 * std::abs(offset(generator))));
+		std::vector<JsonCGAL::ObjectRef> found = json_data.query(box);
+		std::size_t expected = 0;
+		for (const JsonCGAL::Point_2d &point : json_data.view<JsonCGAL::Point_2d>())
+		{
+			expected += CGAL::do_intersect(point, box) ? 1 : 0;
+		}
+		for (const JsonCGAL::Segment_2d &segment : json_data.view<JsonCGAL::Segment_2d>())
+		{
+			expected += CGAL::do_intersect(segment, box) ? 1 : 0;
+		}
+		for (const JsonCGAL::Line_2d &line : json_data.view<JsonCGAL::Line_2d>())
+		{
+			expected += CGAL::do_intersect(line, box) ? 1 : 0;
+		}
+		for (const JsonCGAL::Circle_2d &circle : json_data.view<JsonCGAL::Circle_2d>())
+		{
+			expected += CGAL::do_intersect(circle, box) ? 1 : 0;
+		}
+		ASSERT_EQ(found.size(), expected);
+		for (const JsonCGAL::ObjectRef &object : found)
+		{
+			ASSERT_NE(object.type, JsonCGAL::SupportedTypes::vector_2);
+		}
+	}
+
+	/* objects added after a query are found by the next one */
+	Kernel::Iso_rectangle_2 empty_region(Kernel::Point_2(500, 500), Kernel::Point_2(600, 600));
+	ASSERT_TRUE(json_data.query<JsonCGAL::Point_2d>(empty_region).empty());
+	json_data.emplace_object<JsonCGAL::Point_2d>(550, 550);
+	std::vector<const JsonCGAL::Point_2d *> points = json_data.query<JsonCGAL::Point_2d>(empty_region);
+	ASSERT_EQ(points.size(), 1);
+	ASSERT_EQ(points[0]->x(), 550);
+	ASSERT_TRUE(json_data.query<JsonCGAL::Segment_2d>(empty_region).empty());
+}
+
+TEST(JsonCGALTests, TestConcurrentQueriesBuildOneIndex)
+{
+	JsonCGAL::JsonCGAL json_data;
+	for (int i = 0; i < 5000; i++)
+	{
+		json_data.emplace_object<JsonCGAL::Point_2d>(i % 100, i / 100);
+	}
+	Kernel::Iso_rectangle_2 box(Kernel::Point_2(10, 10), Kernel::Point_2(19, 19));
+	std::vector<std::future<std::size_t>> queries;
+	for (int i = 0; i < 4; i++)
+	{
+		queries.push_back(std::async(std::launch::async, [&json_data, &box]() { return json_data.query(box).size(); }));
+	}
+	for (std::future<std::size_t> &query : queries)
+	{
+		ASSERT_EQ(query.get(), 100);
+	}
+}
+
+TEST(JsonCGALTests, TestRegionLoadKeepsObjectsInRegion)
+{
+	std::string filename = temp_file("test_region.json");
+	JsonCGAL::JsonCGAL json_data;
+	std::mt19937 generator(11);
+	std::uniform_real_distribution<double> coordinate(-100.0, 100.0);
+	for (int i = 0; i < 500; i++)
+	{
+		Kernel::Point_2 p(coordinate(generator), coordinate(generator));
+		Kernel::Point_2 q(coordinate(generator) / 10, coordinate(generator) / 10);
+		json_data.emplace_object<JsonCGAL::Point_2d>(p.x(), p.y());
+		json_data.emplace_object<JsonCGAL::Segment_2d>(p, Kernel::Point_2(p.x() + q.x(), p.y() + q.y()));
+		json_data.emplace_object<JsonCGAL::Line_2d>(p, q);
+		json_data.emplace_object<JsonCGAL::Circle_2d>(p, 4.0);
+	}
+
+	Kernel::Iso_rectangle_2 region(Kernel::Point_2(-20, -20), Kernel::Point_2(20, 30));
+	std::size_t points = 0;
+	std::size_t segments = 0;
+	std::size_t lines = 0;
+	std::size_t circles = 0;
+	for (const JsonCGAL::Point_2d &point : json_data.view<JsonCGAL::Point_2d>())
+	{
+		points += CGAL::do_overlap(point.bbox(), region.bbox()) ? 1 : 0;
+	}
+	for (const JsonCGAL::Segment_2d &segment : json_data.view<JsonCGAL::Segment_2d>())
+	{
+		segments += CGAL::do_overlap(segment.bbox(), region.bbox()) ? 1 : 0;
+	}
+	for (const JsonCGAL::Line_2d &line : json_data.view<JsonCGAL::Line_2d>())
+	{
+		lines += CGAL::do_intersect(line, region) ? 1 : 0;
+	}
+	for (const JsonCGAL::Circle_2d &circle : json_data.view<JsonCGAL::Circle_2d>())
+	{
+		circles += CGAL::do_overlap(circle.bbox(), region.bbox()) ? 1 : 0;
+	}
+	ASSERT_GT(points, 0);
+	ASSERT_LT(points, 500);
+
+	std::vector<JsonCGAL::DumpOptions> formats(5);
+	formats[1].schema = JsonCGAL::JsonSchema::compact;
+	formats[2].schema = JsonCGAL::JsonSchema::columnar;
+	formats[3].format = JsonCGAL::FileFormat::json_lines;
+	formats[4].format = JsonCGAL::FileFormat::binary;
+	for (const JsonCGAL::DumpOptions &format : formats)
+	{
+		JsonCGAL::LoadOptions options;
+		options.threads = 4;
+		JsonCGAL::JsonCGAL load_json_data;
+		ASSERT_TRUE(load_json_data.load_from_string(json_data.dump_to_string(format), region, options));
+		ASSERT_EQ(load_json_data.count<JsonCGAL::Point_2d>(), points);
+		ASSERT_EQ(load_json_data.count<JsonCGAL::Segment_2d>(), segments);
+		ASSERT_EQ(load_json_data.count<JsonCGAL::Line_2d>(), lines);
+		ASSERT_EQ(load_json_data.count<JsonCGAL::Circle_2d>(), circles);
+		ASSERT_EQ(load_json_data.size(), points + segments + lines + circles);
+	}
+
+	/* the region only applies to the load it was given to */
+	ASSERT_TRUE(json_data.dump(filename));
+	JsonCGAL::JsonCGAL load_json_data;
+	ASSERT_TRUE(load_json_data.load(filename, region));
+	ASSERT_EQ(load_json_data.count<JsonCGAL::Point_2d>(), points);
+	ASSERT_FALSE(load_json_data.load_from_string("[", region));
+	ASSERT_TRUE(load_json_data.load(filename));
+	ASSERT_EQ(load_json_data.count<JsonCGAL::Point_2d>(), points + 500);
+	std::remove(filename.c_str());
+}
+
 TEST(JsonCGALTests, TestDumpingToString)
 {
 	JsonCGAL::JsonCGAL json_data;
@@ -109,6 +867,21 @@ TEST(JsonCGALTests, TestDumpingToString)
 	ASSERT_GE(test_string.length(), 5);
 }
 
+TEST(TypeRegistryTests, TestTypeKeysRoundTrip)
+{
+	JsonCGAL::SupportedTypes::SupportedTypes type;
+	for (std::size_t i = 0; i < JsonCGAL::type_key_count; i++)
+	{
+		ASSERT_TRUE(JsonCGAL::find_type(JsonCGAL::type_keys[i], type));
+		ASSERT_EQ(type, i);
+	}
+	ASSERT_FALSE(JsonCGAL::find_type("point_9", type));
+	ASSERT_FALSE(JsonCGAL::find_type("", type));
+	static_assert(JsonCGAL::type_traits<JsonCGAL::Circle_2d>::type == JsonCGAL::SupportedTypes::circle_2, "");
+	static_assert(sizeof(JsonCGAL::Point_2d) == sizeof(Kernel::Point_2), "wrappers add no per object state");
+	ASSERT_STREQ(JsonCGAL::type_traits<JsonCGAL::Segment_2d>::key, "segment_2");
+}
+
 TEST(PointTests, TestEncodingPoint)
 {
    JsonCGAL::Point_2d p(-1, 0);
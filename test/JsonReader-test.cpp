@@ -0,0 +1,147 @@
+/**
+ * @file JsonReader-test.cpp
+ * @author Graham Riches (graham.riches@live.com)
+ * @brief unit tests for the geometry specialized json reader
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include <cstring>
+#include <random>
+
+#include "gtest/gtest.h"
+#include "JsonCGAL.h"
+#include "JsonCGALReader.h"
+#include "JsonCGALScanner.h"
+#include "JsonCGALTypes.h"
+#include "json.hpp"
+#include "cgal_kernel_config.h"
+
+TEST(ReaderTests, TestNumbersMatchGeneralParser)
+{
+	const char *numbers[] = {"0", "-0", "-0.0", "1", "-17", "0.1", "2.5e-3", "1E22", "1e23", "9007199254740993",
+	                         "12345678901234567890123", "0.30000000000000004", "4.9e-324", "2.2250738585072014e-308",
+	                         "1.7976931348623157e308", "123456.789e-5", "0.000000000000000000000000123"};
+	for (const char *number : numbers)
+	{
+		double value = 1.0;
+		ASSERT_TRUE(JsonCGAL::parse_json_double(number, number + std::strlen(number), value)) << number;
+		double expected = nlohmann::json::parse(number).get<double>();
+		ASSERT_EQ(std::memcmp(&value, &expected, sizeof(double)), 0) << number;
+	}
+
+	std::mt19937_64 generator(7);
+	std::uniform_real_distribution<double> distribution(-1e6, 1e6);
+	for (int i = 0; i < 10000; i++)
+	{
+		std::string text = nlohmann::json(distribution(generator)).dump();
+		double value;
+		ASSERT_TRUE(JsonCGAL::parse_json_double(text.data(), text.data() + text.size(), value));
+		ASSERT_EQ(value, nlohmann::json::parse(text).get<double>()) << text;
+	}
+}
+
+TEST(ReaderTests, TestInvalidNumbersAreRejected)
+{
+	const char *numbers[] = {"", "-", "01", "1.", ".5", "1e", "1e+", "+1", "1.2.3", "--1", "1e400"};
+	for (const char *number : numbers)
+	{
+		double value;
+		ASSERT_FALSE(JsonCGAL::parse_json_double(number, number + std::strlen(number), value)) << number;
+	}
+}
+
+TEST(ReaderTests, TestReaderProducesSameObjectsAsGeneralParser)
+{
+	std::string json_string =
+		"\xEF\xBB\xBF [ {\"type\" : \"point_2\", \"coordinates\":[ 1.5 ,\t-2e1 ]},\r\n"
+		"{\"points\": [{\"type\": \"point_2\", \"coordinates\": [0, 0.25]}, {\"coordinates\": [3, 4], \"type\": \"point_2\"}], \"type\": \"segment_2\"},"
+		"[\"circle_2\", [1, 2, 0.0625, -1]], {\"type\": \"point_2\", \"coordinates\": [0.1, 0.2]} ]";
+	JsonCGAL::JsonCGAL json_data;
+	ASSERT_TRUE(json_data.load_from_string(json_string));
+	CGAL_list<JsonCGAL::Point_2d> points = json_data.get_objects<JsonCGAL::Point_2d>();
+	ASSERT_EQ(points.size(), 2u);
+	ASSERT_EQ(points[0], JsonCGAL::Point_2d(1.5, -20));
+	ASSERT_EQ(points[1], JsonCGAL::Point_2d(0.1, 0.2));
+	ASSERT_EQ(json_data.count<JsonCGAL::Segment_2d>(), 1u);
+	ASSERT_EQ(json_data.count<JsonCGAL::Circle_2d>(), 1u);
+}
+
+TEST(ReaderTests, TestEscapedStringsFallBackToGeneralParser)
+{
+	/* the fast reader does not decode escapes, the general parser does */
+	JsonCGAL::JsonCGAL json_data;
+	ASSERT_TRUE(json_data.load_from_string(R"([{"type": "point\u005f2", "coordinates": [1, 2]}])"));
+	ASSERT_EQ(json_data.count<JsonCGAL::Point_2d>(), 1u);
+
+	JsonCGAL::LoadOptions options;
+	options.threads = 4;
+	std::string json_string = "[";
+	for (int i = 0; i < 20000; i++)
+	{
+		json_string += (i == 0) ? "" : ",";
+		json_string += (i == 12345) ? R"({"type": "point\u005f2", "coordinates": [1, 2]})" : R"({"type": "point_2", "coordinates": [1, 2]})";
+	}
+	json_string += "]";
+	JsonCGAL::JsonCGAL parallel;
+	ASSERT_TRUE(parallel.load_from_string(json_string, options));
+	ASSERT_EQ(parallel.count<JsonCGAL::Point_2d>(), 20000u);
+}
+
+TEST(ReaderTests, TestMalformedTextIsRejected)
+{
+	const char *documents[] = {"[", "[1,]", "[1 2]", "{\"a\" 1}", "[tru]", "[] []", "[{\"type\": \"point_2\", \"coordinates\": [1, 2]}"};
+	for (const char *document : documents)
+	{
+		JsonCGAL::JsonCGAL json_data;
+		ASSERT_FALSE(json_data.load_from_string(document)) << document;
+		ASSERT_EQ(json_data.size(), 0u);
+	}
+}
+
+TEST(ReaderTests, TestSkippingContainersIgnoresBracketsInStrings)
+{
+	std::string padding(100, ' ');
+	std::string plain = "{\"a\": [1, 2, {\"b\": \"]}]}\"}]," + padding + "\"c\": \"[[{{\"}";
+	std::string escaped = "[\"\\\"]\", [\"\\\\\"]," + padding + "{}]";
+	for (const std::string &container : {plain, escaped})
+	{
+		std::string text = container + ", [1]";
+		const char *end = JsonCGAL::skip_json_container(text.data(), text.data() + text.size());
+		ASSERT_EQ(end, text.data() + container.size()) << container;
+		ASSERT_EQ(JsonCGAL::skip_json_container(container.data(), container.data() + container.size() - 1), nullptr);
+	}
+}
+
+TEST(ReaderTests, TestSplittingArraysKeepsWholeElements)
+{
+	std::string text = "\xEF\xBB\xBF [";
+	for (int i = 0; i < 200; i++)
+	{
+		text += (i > 0) ? " ,\n" : "";
+		text += (i % 2) ? "[\"point_2\", [1, 2]]" : "{\"type\": \"point_2\", \"coordinates\": [3, 4], \"note\": \"],{\\\"\"}";
+	}
+	text += "] \n";
+	std::vector<JsonCGAL::ByteRange> chunks;
+	ASSERT_TRUE(JsonCGAL::split_json_array(text.data(), text.size(), 4, 64, chunks));
+	ASSERT_EQ(chunks.size(), 4u);
+	std::string joined;
+	for (const JsonCGAL::ByteRange &chunk : chunks)
+	{
+		std::string slice = text.substr(chunk.begin, chunk.end - chunk.begin);
+		/* every chunk parses on its own as an array of whole elements */
+		ASSERT_TRUE(nlohmann::json::accept("[" + slice + "]")) << slice;
+		joined += (joined.empty() ? "" : ",") + slice;
+	}
+	ASSERT_EQ(nlohmann::json::parse("[" + joined + "]"), nlohmann::json::parse(text.substr(3)));
+
+	ASSERT_TRUE(JsonCGAL::split_json_array("[ ]", 3, 4, 1, chunks));
+	ASSERT_EQ(chunks.size(), 1u);
+	for (const char *invalid : {"[{}, , {}]", "[{}, 1]", "[{}] {}", "[{}, {}", "{}", "[{}, {]"})
+	{
+		ASSERT_FALSE(JsonCGAL::split_json_array(invalid, std::strlen(invalid), 2, 1, chunks)) << invalid;
+	}
+}
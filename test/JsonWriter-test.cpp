@@ -0,0 +1,227 @@
+/**
+ * @file JsonWriter-test.cpp
+ * @author Graham Riches (graham.riches@live.com)
+ * @brief unit tests for the direct json writer
+ * @version 0.1
+ * @date 2026-10-17
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+
+#include <cstdio>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "JsonCGAL.h"
+#include "JsonCGALTypes.h"
+#include "JsonCGALWriter.h"
+#include "json.hpp"
+#include "cgal_kernel_config.h"
+
+/* path of a scratch file in the test temporary directory */
+static std::string temp_file(const std::string &name)
+{
+	return ::testing::TempDir() + name;
+}
+
+TEST(WriterTests, TestWriterMatchesEncodedSchema)
+{
+	JsonCGAL::JsonCGAL json_data;
+	JsonCGAL::Point_2d point(1, -0.5);
+	JsonCGAL::Segment_2d segment(JsonCGAL::Point_2d(0, 0), JsonCGAL::Point_2d(-1, 2));
+	JsonCGAL::Line_2d line(JsonCGAL::Point_2d(0, 0), JsonCGAL::Point_2d(-1, 1));
+	json_data.add_objects(CGAL_list<JsonCGAL::Point_2d>{point});
+	json_data.add_objects(CGAL_list<JsonCGAL::Segment_2d>{segment});
+	json_data.add_objects(CGAL_list<JsonCGAL::Line_2d>{line});
+	nlohmann::json expected = {point.encode(), segment.encode(), line.encode()};
+	ASSERT_EQ(nlohmann::json::parse(json_data.dump_to_string()), expected);
+}
+
+TEST(WriterTests, TestCompactOutputHasNoWhitespace)
+{
+	JsonCGAL::JsonCGAL json_data;
+	JsonCGAL::DumpOptions options;
+	options.indent = -1;
+	json_data.add_objects(CGAL_list<JsonCGAL::Point_2d>{JsonCGAL::Point_2d(1, 0), JsonCGAL::Point_2d(-1, 2)});
+	ASSERT_EQ(json_data.dump_to_string(options), R"([{"coordinates":[1.0,0.0],"type":"point_2"},{"coordinates":[-1.0,2.0],"type":"point_2"}])");
+	JsonCGAL::JsonCGAL empty;
+	ASSERT_EQ(empty.dump_to_string(), "[]");
+}
+
+TEST(WriterTests, TestNumbersRoundTripExactly)
+{
+	std::string output;
+	JsonCGAL::JsonWriter writer(output, -1);
+	double values[] = {0.1, 1e-300, 1.0 / 3.0, -2.5e17, 123456789.0};
+	writer.begin_array();
+	for (double value : values)
+	{
+		writer.value(value);
+	}
+	writer.end_array();
+	nlohmann::json json = nlohmann::json::parse(output);
+	for (std::size_t i = 0; i < json.size(); i++)
+	{
+		ASSERT_TRUE(json[i].is_number_float());
+		ASSERT_EQ(json[i].get<double>(), values[i]);
+	}
+}
+
+TEST(WriterTests, TestCompactSchemaLayout)
+{
+	JsonCGAL::JsonCGAL json_data;
+	JsonCGAL::DumpOptions options;
+	options.schema = JsonCGAL::JsonSchema::compact;
+	json_data.add_objects(CGAL_list<JsonCGAL::Point_2d>{JsonCGAL::Point_2d(1, 0)});
+	json_data.add_objects(CGAL_list<JsonCGAL::Segment_2d>{JsonCGAL::Segment_2d(JsonCGAL::Point_2d(0, 0.5), JsonCGAL::Point_2d(-1, 2))});
+	ASSERT_EQ(json_data.dump_to_string(options), "[\n    [\"point_2\", [1.0, 0.0]],\n    [\"segment_2\", [0.0, 0.5, -1.0, 2.0]]\n]");
+	options.indent = -1;
+	ASSERT_EQ(json_data.dump_to_string(options), R"([["point_2",[1.0,0.0]],["segment_2",[0.0,0.5,-1.0,2.0]]])");
+}
+
+TEST(WriterTests, TestCompactSchemaRoundTripsEveryType)
+{
+	Kernel::Point_2 p(0.1, -2.5);
+	Kernel::Point_2 q(1e-300, 7.25);
+	Kernel::Point_2 r(-3.0 / 7.0, 1e17);
+	JsonCGAL::JsonCGAL create_json_data;
+	JsonCGAL::JsonCGAL load_json_data;
+	JsonCGAL::DumpOptions options;
+	options.schema = JsonCGAL::JsonSchema::compact;
+	create_json_data.add_objects(CGAL_list<JsonCGAL::Point_2d>{JsonCGAL::Point_2d(0.1, 0.2)});
+	create_json_data.add_objects(CGAL_list<JsonCGAL::Line_2d>{JsonCGAL::Line_2d(p, q)});
+	create_json_data.add_objects(CGAL_list<JsonCGAL::Segment_2d>{JsonCGAL::Segment_2d(p, r)});
+	create_json_data.add_objects(CGAL_list<JsonCGAL::Weighted_point_2d>{JsonCGAL::Weighted_point_2d(p, 0.3)});
+	create_json_data.add_objects(CGAL_list<JsonCGAL::Vector_2d>{JsonCGAL::Vector_2d(1.5, -0.7)});
+	create_json_data.add_objects(CGAL_list<JsonCGAL::Direction_2d>{JsonCGAL::Direction_2d(-1, 1.0 / 3.0)});
+	create_json_data.add_objects(CGAL_list<JsonCGAL::Ray_2d>{JsonCGAL::Ray_2d(q, r)});
+	create_json_data.add_objects(CGAL_list<JsonCGAL::Triangle_2d>{JsonCGAL::Triangle_2d(p, q, r)});
+	create_json_data.add_objects(CGAL_list<JsonCGAL::Iso_rectangle_2d>{JsonCGAL::Iso_rectangle_2d(p, r)});
+	create_json_data.add_objects(CGAL_list<JsonCGAL::Circle_2d>{JsonCGAL::Circle_2d(q, 2.0 / 3.0, CGAL::CLOCKWISE)});
+	std::string compact = create_json_data.dump_to_string(options);
+	ASSERT_TRUE(load_json_data.load_from_string(compact));
+	ASSERT_EQ(load_json_data.size(), create_json_data.size());
+	ASSERT_EQ(load_json_data.dump_to_string(JsonCGAL::FileFormat::binary), create_json_data.dump_to_string(JsonCGAL::FileFormat::binary));
+	ASSERT_EQ(load_json_data.dump_to_string(options), compact);
+}
+
+TEST(WriterTests, TestNestedSchemaRoundTripsEveryType)
+{
+	std::string filename = temp_file("test_nested_types.json");
+	Kernel::Point_2 p(0.1, -2.5);
+	Kernel::Point_2 q(1e-300, 7.25);
+	Kernel::Point_2 r(-3.0 / 7.0, 1e17);
+	JsonCGAL::JsonCGAL create_json_data;
+	JsonCGAL::JsonCGAL load_json_data;
+	JsonCGAL::LoadOptions load_options;
+	create_json_data.add_objects(CGAL_list<JsonCGAL::Point_2d>{JsonCGAL::Point_2d(0.1, 0.2)});
+	create_json_data.add_objects(CGAL_list<JsonCGAL::Weighted_point_2d>{JsonCGAL::Weighted_point_2d(p, 0.3)});
+	create_json_data.add_objects(CGAL_list<JsonCGAL::Vector_2d>{JsonCGAL::Vector_2d(1.5, -0.7)});
+	create_json_data.add_objects(CGAL_list<JsonCGAL::Direction_2d>{JsonCGAL::Direction_2d(-1, 1.0 / 3.0)});
+	create_json_data.add_objects(CGAL_list<JsonCGAL::Ray_2d>{JsonCGAL::Ray_2d(q, r)});
+	create_json_data.add_objects(CGAL_list<JsonCGAL::Triangle_2d>{JsonCGAL::Triangle_2d(p, q, r)});
+	create_json_data.add_objects(CGAL_list<JsonCGAL::Iso_rectangle_2d>{JsonCGAL::Iso_rectangle_2d(p, r)});
+	create_json_data.add_objects(CGAL_list<JsonCGAL::Circle_2d>{JsonCGAL::Circle_2d(q, 2.0 / 3.0, CGAL::CLOCKWISE)});
+	create_json_data.add_objects(CGAL_list<JsonCGAL::Segment_2d>{JsonCGAL::Segment_2d(p, r)});
+	std::string nested = create_json_data.dump_to_string();
+	ASSERT_EQ(nested.find("null"), std::string::npos);
+	ASSERT_NE(nested.find("[\"circle_2\", ["), std::string::npos);
+	ASSERT_TRUE(load_json_data.load_from_string(nested));
+	ASSERT_EQ(load_json_data.dump_to_string(JsonCGAL::FileFormat::binary), create_json_data.dump_to_string(JsonCGAL::FileFormat::binary));
+	ASSERT_EQ(load_json_data.dump_to_string(), nested);
+
+	ASSERT_TRUE(create_json_data.dump(filename));
+	for (bool lazy : {false, true})
+	{
+		load_json_data.clear();
+		load_options.lazy = lazy;
+		ASSERT_TRUE(load_json_data.load(filename, load_options));
+		ASSERT_EQ(load_json_data.count<JsonCGAL::Circle_2d>(), 1);
+		ASSERT_TRUE(load_json_data.view<JsonCGAL::Ray_2d>()[0] == create_json_data.view<JsonCGAL::Ray_2d>()[0]);
+		ASSERT_EQ(load_json_data.dump_to_string(), nested);
+	}
+	std::remove(filename.c_str());
+}
+
+TEST(WriterTests, TestLoadingMixedSchemas)
+{
+	JsonCGAL::JsonCGAL json_data;
+	ASSERT_TRUE(json_data.load_from_string(R"([["point_2", [1, 2]], {"type": "point_2", "coordinates": [3, 4]}, ["circle_2", [0, 0, 4, 1]]])"));
+	ASSERT_EQ(json_data.count<JsonCGAL::Point_2d>(), 2);
+	ASSERT_EQ(json_data.view<JsonCGAL::Point_2d>()[1].x(), 3);
+	ASSERT_EQ(json_data.view<JsonCGAL::Circle_2d>()[0].squared_radius(), 4);
+	ASSERT_FALSE(json_data.load_from_string(R"([["point_2", [1, 2, 3]]])"));
+	ASSERT_FALSE(json_data.load_from_string(R"([["point_9", [1, 2]]])"));
+	ASSERT_FALSE(json_data.load_from_string(R"([[[1, 2], "point_2"]])"));
+	ASSERT_EQ(json_data.size(), 3);
+}
+
+TEST(WriterTests, TestColumnarSchemaRoundTrip)
+{
+	std::string filename = temp_file("test_columnar.json");
+	JsonCGAL::JsonCGAL create_json_data;
+	JsonCGAL::JsonCGAL load_json_data;
+	JsonCGAL::DumpOptions options;
+	options.schema = JsonCGAL::JsonSchema::columnar;
+	options.indent = -1;
+	create_json_data.add_objects(CGAL_list<JsonCGAL::Point_2d>{JsonCGAL::Point_2d(1, 0), JsonCGAL::Point_2d(-1, 2.5)});
+	create_json_data.add_objects(CGAL_list<JsonCGAL::Circle_2d>{JsonCGAL::Circle_2d(Kernel::Point_2(3, 4), 2.0, CGAL::CLOCKWISE)});
+	std::string columnar = create_json_data.dump_to_string(options);
+	ASSERT_EQ(columnar, R"({"point_2":{"x":[1.0,-1.0],"y":[0.0,2.5]},"circle_2":{"x":[3.0],"y":[4.0],"squared_radius":[2.0],"orientation":[-1.0]}})");
+	ASSERT_TRUE(load_json_data.load_from_string(columnar));
+	ASSERT_EQ(load_json_data.dump_to_string(JsonCGAL::FileFormat::binary), create_json_data.dump_to_string(JsonCGAL::FileFormat::binary));
+	options.indent = 4;
+	ASSERT_TRUE(create_json_data.dump(filename, options));
+	ASSERT_TRUE(load_json_data.load(filename));
+	ASSERT_EQ(load_json_data.count<JsonCGAL::Point_2d>(), 4);
+	std::remove(filename.c_str());
+}
+
+TEST(WriterTests, TestJsonLinesRoundTripEveryType)
+{
+	std::string filename = temp_file("test_lines_types.jsonl");
+	Kernel::Point_2 p(0.1, -2.5);
+	Kernel::Point_2 q(1e-300, 7.25);
+	JsonCGAL::JsonCGAL create_json_data;
+	JsonCGAL::JsonCGAL load_json_data;
+	JsonCGAL::DumpOptions options;
+	options.format = JsonCGAL::FileFormat::json_lines;
+	/* json lines ignore the schema option, every type needs the compact encoding */
+	options.schema = JsonCGAL::JsonSchema::nested;
+	create_json_data.add_objects(CGAL_list<JsonCGAL::Circle_2d>{JsonCGAL::Circle_2d(q, 2.0 / 3.0, CGAL::CLOCKWISE)});
+	create_json_data.add_objects(CGAL_list<JsonCGAL::Triangle_2d>{JsonCGAL::Triangle_2d(p, q, Kernel::Point_2(3, 4))});
+	std::string lines = create_json_data.dump_to_string(options);
+	ASSERT_EQ(lines.find("null"), std::string::npos);
+	ASSERT_TRUE(load_json_data.load_from_string(lines));
+	ASSERT_EQ(load_json_data.dump_to_string(JsonCGAL::FileFormat::binary), create_json_data.dump_to_string(JsonCGAL::FileFormat::binary));
+
+	ASSERT_TRUE(create_json_data.dump(filename, options));
+	options.append = true;
+	ASSERT_TRUE(create_json_data.dump(filename, options));
+	std::size_t circles = 0;
+	ASSERT_TRUE(JsonCGAL::JsonCGAL::for_each_object<JsonCGAL::Circle_2d>(filename, [&circles, &create_json_data](const JsonCGAL::Circle_2d &circle)
+	{
+		ASSERT_TRUE(circle == create_json_data.view<JsonCGAL::Circle_2d>()[0]);
+		circles++;
+	}));
+	ASSERT_EQ(circles, 2);
+	load_json_data.clear();
+	ASSERT_TRUE(load_json_data.load(filename));
+	ASSERT_EQ(load_json_data.count<JsonCGAL::Triangle_2d>(), 2);
+	ASSERT_TRUE(load_json_data.view<JsonCGAL::Triangle_2d>()[1] == create_json_data.view<JsonCGAL::Triangle_2d>()[0]);
+	std::remove(filename.c_str());
+}
+
+TEST(WriterTests, TestInvalidColumnarBlocksAreRejected)
+{
+	JsonCGAL::JsonCGAL json_data;
+	ASSERT_TRUE(json_data.load_from_string(R"({"point_2": {"y": [2], "x": [1], "z": [0]}})"));
+	ASSERT_FALSE(json_data.load_from_string(R"({"point_2": {"x": [1, 2], "y": [2]}})"));
+	ASSERT_FALSE(json_data.load_from_string(R"({"point_2": {"x": [1]}})"));
+	ASSERT_FALSE(json_data.load_from_string(R"({"point_2": {"x": [1], "x": [1], "y": [2]}})"));
+	ASSERT_FALSE(json_data.load_from_string(R"({"point_9": {"x": [1], "y": [2]}})"));
+	ASSERT_FALSE(json_data.load_from_string(R"({"point_2": [1, 2]})"));
+	ASSERT_EQ(json_data.size(), 1);
+	ASSERT_EQ(json_data.view<JsonCGAL::Point_2d>()[0].y(), 2);
+}